@@ -0,0 +1,368 @@
+#include "channelizer.h"
+#include <common/common.h>
+
+#define LOG_LEVEL LOG_INFO
+#include <ft8/debug.h>
+
+#include <stdlib.h>
+#include <math.h>
+
+// Stopband attenuation of the channel filters in dB, and the corresponding Kaiser window shape
+#define CHANNELIZER_ATTEN_DB (60.0)
+#define CHANNELIZER_KAISER_BETA (0.1102 * (CHANNELIZER_ATTEN_DB - 8.7))
+
+// Standard dial frequencies (USB) in Hertz
+static const double kFT8_dial_freq[] = { 1840000, 3573000, 5357000, 7074000, 10136000, 14074000, 18100000, 21074000, 24915000, 28074000, 50313000, 144174000 };
+static const double kFT4_dial_freq[] = { 3575000, 7047500, 10140000, 14080000, 18104000, 21140000, 24919000, 28180000, 50318000, 144170000 };
+
+// Zeroth order modified Bessel function of the first kind
+static double bessel_i0(double x)
+{
+    double sum = 1;
+    double term = 1;
+    for (int k = 1; k < 50; ++k)
+    {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if (term < sum * 1E-12)
+            break;
+    }
+    return sum;
+}
+
+// Number of taps of a Kaiser window lowpass filter with the given transition width (relative to the sample rate)
+static int kaiser_length(double transition)
+{
+    return (int)ceil((CHANNELIZER_ATTEN_DB - 8) / (2.285 * 2 * M_PI * transition)) + 1;
+}
+
+// Tap i of a Kaiser windowed sinc lowpass filter (before normalization), cutoff relative to the sample rate
+static double lowpass_tap(int i, int num_taps, double cutoff)
+{
+    double center = (num_taps - 1) / 2.0;
+    double t = i - center;
+    double sinc = (t == 0) ? 2 * cutoff : sin(2 * M_PI * cutoff * t) / (M_PI * t);
+    double r = t / (center + 0.5);
+    return sinc * bessel_i0(CHANNELIZER_KAISER_BETA * sqrt(1 - r * r)) / bessel_i0(CHANNELIZER_KAISER_BETA);
+}
+
+// Kaiser windowed sinc lowpass filter with unity DC gain, cutoff relative to the sample rate.
+// The taps are computed twice (sum, then normalized values) to keep the double precision without a buffer.
+static void design_lowpass(float* taps, int num_taps, double cutoff)
+{
+    double sum = 0;
+    for (int i = 0; i < num_taps; ++i)
+    {
+        sum += lowpass_tap(i, num_taps, cutoff);
+    }
+    for (int i = 0; i < num_taps; ++i)
+    {
+        taps[i] = (float)(lowpass_tap(i, num_taps, cutoff) / sum);
+    }
+}
+
+// Half-widths of the sub-band around its center: the analysis band itself, and the start of the stopband.
+// Everything below the audio frequency -f_min must be rejected, since USB demodulation folds it onto the analysis band.
+static void slice_bandwidth(const channelizer_config_t* cfg, float* half_pass, float* half_stop)
+{
+    float guard = fmaxf(cfg->f_min, 100.0f);
+    *half_pass = (cfg->f_max - cfg->f_min) / 2;
+    *half_stop = *half_pass + 2 * guard;
+}
+
+// Offset of the sub-band center from the IQ center frequency
+static double slice_offset(const channelizer_config_t* cfg, double dial_freq)
+{
+    return dial_freq - cfg->center_freq + (cfg->f_min + cfg->f_max) / 2;
+}
+
+static bool slice_in_range(const channelizer_config_t* cfg, double dial_freq)
+{
+    float half_pass, half_stop;
+    slice_bandwidth(cfg, &half_pass, &half_stop);
+    return fabs(slice_offset(cfg, dial_freq)) + half_stop < cfg->sample_rate / 2.0;
+}
+
+int channelizer_find_dials(ftx_protocol_t protocol, const channelizer_config_t* cfg, double* dial_freq, int max_dials)
+{
+    const double* table = (protocol == FTX_PROTOCOL_FT4) ? kFT4_dial_freq : kFT8_dial_freq;
+    int table_size = (protocol == FTX_PROTOCOL_FT4) ? (int)(sizeof(kFT4_dial_freq) / sizeof(kFT4_dial_freq[0]))
+                                                    : (int)(sizeof(kFT8_dial_freq) / sizeof(kFT8_dial_freq[0]));
+    int num_dials = 0;
+    for (int idx = 0; idx < table_size && num_dials < max_dials; ++idx)
+    {
+        if (slice_in_range(cfg, table[idx]))
+        {
+            dial_freq[num_dials] = table[idx];
+            ++num_dials;
+        }
+    }
+    return num_dials;
+}
+
+bool channelizer_init(channelizer_t* me, const channelizer_config_t* cfg, int num_slices, const double* dial_freq, const ftx_protocol_t* protocol)
+{
+    float half_pass, half_stop;
+    slice_bandwidth(cfg, &half_pass, &half_stop);
+    const int min_audio_rate = (cfg->audio_rate > 0) ? cfg->audio_rate : 12000;
+
+    // Pick the largest filter bank whose channels (at twice the channel spacing) still reach the audio rate
+    // with an integer decimation, and are wide enough to hold any sub-band with some room for the transition
+    me->num_bank = 0;
+    for (int num_bank = 2 * (cfg->sample_rate / min_audio_rate); num_bank >= 2; num_bank -= 2)
+    {
+        int hop = num_bank / 2;
+        if (cfg->sample_rate % hop != 0)
+            continue;
+        int bank_rate = cfg->sample_rate / hop;
+        double spacing = (double)cfg->sample_rate / num_bank;
+        int decimation = bank_rate / min_audio_rate;
+        if ((decimation < 1) || (bank_rate % decimation != 0) || (spacing < 8 * half_stop / 3))
+            continue;
+        me->num_bank = num_bank;
+        me->hop = hop;
+        me->bank_rate = bank_rate;
+        me->decimation = decimation;
+        me->audio_rate = bank_rate / decimation;
+        break;
+    }
+    if (me->num_bank == 0)
+    {
+        LOG(LOG_ERROR, "Unsupported IQ sample rate %d\n", cfg->sample_rate);
+        return false;
+    }
+    for (int idx = 0; idx < num_slices; ++idx)
+    {
+        if (!slice_in_range(cfg, dial_freq[idx]))
+        {
+            LOG(LOG_ERROR, "Dial frequency %.0f is outside the IQ bandwidth\n", dial_freq[idx]);
+            return false;
+        }
+    }
+    me->sample_rate = cfg->sample_rate;
+    me->prototype = NULL;
+    me->history = NULL;
+    me->fold_in = NULL;
+    me->fold_out = NULL;
+    me->fft_cfg = NULL;
+    me->num_slices = 0;
+    me->slices = NULL;
+
+    // Prototype filter: flat over any sub-band within half a channel spacing of the channel center,
+    // and attenuating everything that would alias onto it at the filter bank rate
+    const double spacing = (double)cfg->sample_rate / me->num_bank;
+    const double transition = spacing - 2 * half_stop;
+    me->num_taps = kaiser_length(transition / cfg->sample_rate);
+    me->num_taps = ((me->num_taps + me->num_bank - 1) / me->num_bank) * me->num_bank;
+    me->prototype = (float*)malloc(me->num_taps * sizeof(float));
+    me->history = (float*)calloc(4 * me->num_taps, sizeof(float));
+    me->history_pos = 0;
+    me->hop_pos = 0;
+    me->bank_phase = me->num_bank - 1;
+    me->fold_in = (kiss_fft_cpx*)malloc(me->num_bank * sizeof(kiss_fft_cpx));
+    me->fold_out = (kiss_fft_cpx*)malloc(me->num_bank * sizeof(kiss_fft_cpx));
+    me->fft_cfg = kiss_fft_alloc(me->num_bank, 1, NULL, NULL);
+    if ((me->prototype == NULL) || (me->history == NULL) || (me->fold_in == NULL) || (me->fold_out == NULL) || (me->fft_cfg == NULL))
+    {
+        LOG(LOG_ERROR, "ERROR: cannot allocate the filter bank\n");
+        channelizer_free(me);
+        return false;
+    }
+    design_lowpass(me->prototype, me->num_taps, spacing / cfg->sample_rate);
+
+    LOG(LOG_INFO, "Filter bank: %d channels, %d taps, %d Hz\n", me->num_bank, me->num_taps, me->bank_rate);
+    LOG(LOG_INFO, "Audio sample rate = %d\n", me->audio_rate);
+
+    // Fine channel filter: passes the analysis band, stops below the audio frequency -f_min
+    const int num_taps = kaiser_length((half_stop - half_pass) / me->bank_rate);
+    const double cutoff = (half_pass + half_stop) / 2 / me->bank_rate;
+    const double audio_center = (cfg->f_min + cfg->f_max) / 2;
+
+    monitor_config_t mon_cfg = {
+        .f_min = cfg->f_min,
+        .f_max = cfg->f_max,
+        .sample_rate = me->audio_rate,
+        .time_osr = cfg->time_osr,
+        .freq_osr = cfg->freq_osr,
+    };
+
+    // Zeroed sub-bands can be released by channelizer_free() at any point of their setup
+    me->slices = (channelizer_slice_t*)calloc(num_slices, sizeof(channelizer_slice_t));
+    if (me->slices == NULL)
+    {
+        LOG(LOG_ERROR, "ERROR: cannot allocate the sub-bands\n");
+        channelizer_free(me);
+        return false;
+    }
+    me->num_slices = num_slices;
+    for (int idx = 0; idx < num_slices; ++idx)
+    {
+        channelizer_slice_t* slice = &me->slices[idx];
+        double offset = slice_offset(cfg, dial_freq[idx]);
+        int bin = (int)lround(offset / spacing);
+        // Remaining offset of the sub-band center from the filter bank channel center
+        double delta = offset - bin * spacing;
+
+        slice->dial_freq = dial_freq[idx];
+        slice->bank_bin = (bin + me->num_bank) % me->num_bank;
+        slice->num_taps = num_taps;
+        slice->taps = (float*)malloc(2 * num_taps * sizeof(float));
+        slice->history = (float*)calloc(4 * num_taps, sizeof(float));
+        mon_cfg.protocol = protocol[idx];
+        if ((slice->taps == NULL) || (slice->history == NULL) || !monitor_init_mem(&slice->mon, &mon_cfg, NULL, NULL))
+        {
+            LOG(LOG_ERROR, "ERROR: cannot allocate the sub-band at %.0f Hz\n", dial_freq[idx]);
+            channelizer_free(me);
+            return false;
+        }
+        slice->frame = (float*)malloc(slice->mon.block_size * sizeof(float));
+        if (slice->frame == NULL)
+        {
+            LOG(LOG_ERROR, "ERROR: cannot allocate the sub-band at %.0f Hz\n", dial_freq[idx]);
+            channelizer_free(me);
+            return false;
+        }
+        slice->frame_pos = 0;
+
+        // The lowpass filter is designed into the upper half of the taps, then shifted to the sub-band offset
+        // in place: complex tap i overwrites only lowpass taps up to i
+        float* lowpass = slice->taps + num_taps;
+        design_lowpass(lowpass, num_taps, cutoff);
+        for (int i = 0; i < num_taps; ++i)
+        {
+            double phase = 2 * M_PI * delta * i / me->bank_rate;
+            float tap = lowpass[i];
+            slice->taps[2 * i] = (float)(tap * cos(phase));
+            slice->taps[2 * i + 1] = (float)(tap * sin(phase));
+        }
+        slice->history_pos = 0;
+        slice->decim_phase = me->decimation;
+        // Shift the sub-band center down by delta, then up by the audio center frequency
+        double step = 2 * M_PI * (audio_center - delta) / me->audio_rate;
+        slice->step_re = cos(step);
+        slice->step_im = sin(step);
+        slice->osc_re = 1;
+        slice->osc_im = 0;
+
+        LOG(LOG_DEBUG, "Dial %.0f: channel %d, offset %.1f Hz\n", slice->dial_freq, slice->bank_bin, delta);
+    }
+    return true;
+}
+
+void channelizer_free(channelizer_t* me)
+{
+    for (int idx = 0; idx < me->num_slices; ++idx)
+    {
+        channelizer_slice_t* slice = &me->slices[idx];
+        monitor_free(&slice->mon);
+        free(slice->taps);
+        free(slice->history);
+        free(slice->frame);
+    }
+    free(me->slices);
+    free(me->prototype);
+    free(me->history);
+    free(me->fold_in);
+    free(me->fold_out);
+    kiss_fft_free(me->fft_cfg);
+}
+
+void channelizer_reset(channelizer_t* me)
+{
+    for (int idx = 0; idx < me->num_slices; ++idx)
+    {
+        channelizer_slice_t* slice = &me->slices[idx];
+        monitor_reset(&slice->mon);
+        slice->frame_pos = 0;
+    }
+}
+
+// Feed one filter bank output into the fine channel filter and produce an audio sample every decimation outputs
+static void slice_process(channelizer_t* me, channelizer_slice_t* slice, float re, float im)
+{
+    // Mirrored ring buffer with the newest sample first, so that the filter always reads contiguous memory
+    slice->history_pos = (slice->history_pos == 0) ? (slice->num_taps - 1) : (slice->history_pos - 1);
+    float* hist = slice->history + 2 * slice->history_pos;
+    hist[0] = hist[2 * slice->num_taps] = re;
+    hist[1] = hist[2 * slice->num_taps + 1] = im;
+
+    if (--slice->decim_phase > 0)
+        return;
+    slice->decim_phase = me->decimation;
+
+    const float* taps = slice->taps;
+    float sum_re = 0;
+    float sum_im = 0;
+    for (int i = 0; i < slice->num_taps; ++i)
+    {
+        sum_re += taps[2 * i] * hist[2 * i] - taps[2 * i + 1] * hist[2 * i + 1];
+        sum_im += taps[2 * i] * hist[2 * i + 1] + taps[2 * i + 1] * hist[2 * i];
+    }
+
+    // USB demodulation: rotate the sub-band to the audio frequencies and keep the real part
+    slice->frame[slice->frame_pos] = (float)(sum_re * slice->osc_re - sum_im * slice->osc_im);
+    double osc_re = slice->osc_re * slice->step_re - slice->osc_im * slice->step_im;
+    double osc_im = slice->osc_re * slice->step_im + slice->osc_im * slice->step_re;
+    // Keep the oscillator at unit magnitude
+    double gain = (3 - (osc_re * osc_re + osc_im * osc_im)) / 2;
+    slice->osc_re = osc_re * gain;
+    slice->osc_im = osc_im * gain;
+
+    if (++slice->frame_pos == slice->mon.block_size)
+    {
+        monitor_process(&slice->mon, slice->frame);
+        slice->frame_pos = 0;
+    }
+}
+
+// Compute the outputs of all filter bank channels for the newest input sample:
+// y[k] = sum_i h[i] * x[t - i] * exp(-j*2*pi*k*(t - i)/M), evaluated as an M-point inverse DFT of the
+// polyphase components of the filtered input, followed by a phase correction of exp(-j*2*pi*k*t/M).
+static void bank_process(channelizer_t* me)
+{
+    const int num_bank = me->num_bank;
+    const float* hist = me->history + 2 * me->history_pos;
+    for (int m = 0; m < num_bank; ++m)
+    {
+        float sum_re = 0;
+        float sum_im = 0;
+        for (int i = m; i < me->num_taps; i += num_bank)
+        {
+            sum_re += me->prototype[i] * hist[2 * i];
+            sum_im += me->prototype[i] * hist[2 * i + 1];
+        }
+        me->fold_in[m].r = sum_re;
+        me->fold_in[m].i = sum_im;
+    }
+    kiss_fft(me->fft_cfg, me->fold_in, me->fold_out);
+
+    for (int idx = 0; idx < me->num_slices; ++idx)
+    {
+        channelizer_slice_t* slice = &me->slices[idx];
+        const kiss_fft_cpx* y = &me->fold_out[slice->bank_bin];
+        double phase = -2 * M_PI * ((slice->bank_bin * me->bank_phase) % num_bank) / num_bank;
+        float rot_re = (float)cos(phase);
+        float rot_im = (float)sin(phase);
+        slice_process(me, slice, y->r * rot_re - y->i * rot_im, y->r * rot_im + y->i * rot_re);
+    }
+}
+
+void channelizer_process(channelizer_t* me, const float* iq, int num_samples)
+{
+    for (int pos = 0; pos < num_samples; ++pos)
+    {
+        // Mirrored ring buffer with the newest sample first
+        me->history_pos = (me->history_pos == 0) ? (me->num_taps - 1) : (me->history_pos - 1);
+        float* hist = me->history + 2 * me->history_pos;
+        hist[0] = hist[2 * me->num_taps] = iq[2 * pos];
+        hist[1] = hist[2 * me->num_taps + 1] = iq[2 * pos + 1];
+        if (++me->bank_phase == me->num_bank)
+            me->bank_phase = 0;
+
+        if (++me->hop_pos == me->hop)
+        {
+            me->hop_pos = 0;
+            bank_process(me);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef _INCLUDE_CHANNELIZER_H_
+#define _INCLUDE_CHANNELIZER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <common/monitor.h>
+#include <fft/kiss_fft.h>
+
+/// Configuration options for the wideband IQ channelizer
+typedef struct
+{
+    int sample_rate;    ///< IQ sample rate in Hertz
+    double center_freq; ///< RF frequency corresponding to 0 Hz in the IQ stream
+    float f_min;        ///< Lower audio frequency bound for analysis in each channel
+    float f_max;        ///< Upper audio frequency bound for analysis in each channel
+    int audio_rate;     ///< Minimum audio sample rate of the channels in Hertz (12000 if left zero)
+    int time_osr;       ///< Number of time subdivisions of the channel waterfalls
+    int freq_osr;       ///< Number of frequency subdivisions of the channel waterfalls
+} channelizer_config_t;
+
+/// One FT8/FT4 sub-band extracted from the IQ stream, demodulated as USB audio
+typedef struct
+{
+    double dial_freq; ///< RF dial frequency in Hertz
+    int bank_bin;     ///< Filter bank channel that contains the sub-band
+    int num_taps;     ///< Length of the fine channel filter
+    float* taps;      ///< Fine channel filter, shifted to the sub-band offset (num_taps complex values)
+    float* history;   ///< Filter bank outputs of this channel (2 x num_taps complex values, mirrored ring)
+    int history_pos;  ///< Ring buffer position of the newest filter bank output
+    int decim_phase;  ///< Filter bank outputs until the next audio sample
+    double osc_re;    ///< Phase rotation of the next audio sample (real part)
+    double osc_im;    ///< Phase rotation of the next audio sample (imaginary part)
+    double step_re;   ///< Phase rotation per audio sample (real part)
+    double step_im;   ///< Phase rotation per audio sample (imaginary part)
+    float* frame;     ///< Audio samples collected for the next monitor frame (block_size samples)
+    int frame_pos;    ///< Number of samples in frame
+    monitor_t mon;    ///< Monitor producing the waterfall of this sub-band
+} channelizer_slice_t;
+
+/// Polyphase channelizer that splits one wideband complex IQ stream into FT8/FT4 sub-bands.
+/// A 2x oversampled uniform DFT filter bank (one shared pass over the input per hop) splits the stream into
+/// num_bank channels. Each sub-band is then tuned, filtered and decimated from its filter bank channel into
+/// USB audio at audio_rate, which is fed into a monitor_t of its own.
+typedef struct
+{
+    int sample_rate;  ///< IQ sample rate in Hertz
+    int num_bank;     ///< Number of filter bank channels (DFT size)
+    int hop;          ///< Input samples per filter bank output (num_bank / 2)
+    int bank_rate;    ///< Sample rate of the filter bank channels in Hertz
+    int decimation;   ///< Filter bank outputs per audio sample
+    int audio_rate;   ///< Audio sample rate of the channels in Hertz
+    int num_taps;     ///< Length of the prototype filter (a multiple of num_bank)
+    float* prototype; ///< Prototype lowpass filter of the filter bank
+    float* history;   ///< Input samples (2 x num_taps complex values, mirrored ring, newest first)
+    int history_pos;  ///< Ring buffer position of the newest input sample
+    int hop_pos;      ///< Input samples received since the last filter bank output
+    int bank_phase;   ///< Input sample index of the newest sample modulo num_bank
+    kiss_fft_cpx* fold_in;  ///< Prototype filter output folded to num_bank points
+    kiss_fft_cpx* fold_out; ///< Filter bank outputs of all channels
+    kiss_fft_cfg fft_cfg;   ///< Kiss FFT housekeeping object
+    int num_slices;              ///< Number of sub-bands
+    channelizer_slice_t* slices; ///< Sub-bands (num_slices entries)
+} channelizer_t;
+
+/// Initialize the channelizer for a set of dial frequencies
+/// @param[out] me Channelizer object
+/// @param[in] cfg Channelizer configuration
+/// @param[in] num_slices Number of sub-bands
+/// @param[in] dial_freq RF dial frequencies of the sub-bands in Hertz (num_slices entries)
+/// @param[in] protocol Protocol of each sub-band (num_slices entries)
+/// @return True on success, false if a sub-band is outside the IQ bandwidth or the sample rate is not supported
+bool channelizer_init(channelizer_t* me, const channelizer_config_t* cfg, int num_slices, const double* dial_freq, const ftx_protocol_t* protocol);
+void channelizer_free(channelizer_t* me);
+
+/// Reset the waterfalls of all sub-bands (e.g. at the start of a new time slot)
+void channelizer_reset(channelizer_t* me);
+
+/// Process a number of IQ samples, updating the waterfalls of all sub-bands
+/// @param[in] iq Complex samples as interleaved (I, Q) pairs
+/// @param[in] num_samples Number of complex samples
+void channelizer_process(channelizer_t* me, const float* iq, int num_samples);
+
+/// Find the standard FT8/FT4 dial frequencies covered by an IQ stream
+/// @param[in] protocol Protocol (FT4 or FT8)
+/// @param[in] cfg Channelizer configuration (sample rate, center frequency and analysis band)
+/// @param[out] dial_freq Dial frequencies in Hertz
+/// @param[in] max_dials Maximum number of dial frequencies to return
+/// @return Number of dial frequencies found
+int channelizer_find_dials(ftx_protocol_t protocol, const channelizer_config_t* cfg, double* dial_freq, int max_dials);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _INCLUDE_CHANNELIZER_H_
@@ -0,0 +1,125 @@
+#include "dt_estimator.h"
+
+#include <math.h>
+
+// Widest window, the time offsets searched by ftx_find_candidates()
+static void set_full_window(dt_estimator_t* me)
+{
+    me->time_offset_min = DT_ESTIMATOR_OFFSET_MIN;
+    me->time_offset_max = DT_ESTIMATOR_OFFSET_MIN + DT_ESTIMATOR_NUM_OFFSETS - 1;
+}
+
+// Index of the histogram bin where the cumulated weight reaches a fraction of the total weight
+static int find_quantile(const dt_estimator_t* me, float fraction)
+{
+    float limit = fraction * me->weight;
+    float sum = 0;
+    for (int idx = 0; idx < DT_ESTIMATOR_NUM_OFFSETS; ++idx)
+    {
+        sum += me->histogram[idx];
+        if (sum >= limit)
+            return idx;
+    }
+    return DT_ESTIMATOR_NUM_OFFSETS - 1;
+}
+
+void dt_estimator_init(dt_estimator_t* me, const dt_estimator_config_t* cfg)
+{
+    me->cfg = *cfg;
+    for (int idx = 0; idx < DT_ESTIMATOR_NUM_OFFSETS; ++idx)
+    {
+        me->histogram[idx] = 0;
+    }
+    me->weight = 0;
+    me->mean_decodes = 0;
+    me->num_slots = 0;
+    me->num_decodes = 0;
+    me->center = 0;
+    me->widened = false;
+    set_full_window(me);
+}
+
+void dt_estimator_add(dt_estimator_t* me, float time)
+{
+    int idx = (int)floorf(time / me->cfg.symbol_period) - DT_ESTIMATOR_OFFSET_MIN;
+    if (idx < 0)
+        idx = 0;
+    if (idx >= DT_ESTIMATOR_NUM_OFFSETS)
+        idx = DT_ESTIMATOR_NUM_OFFSETS - 1;
+    me->histogram[idx] += 1;
+    me->weight += 1;
+    ++me->num_decodes;
+}
+
+void dt_estimator_end_slot(dt_estimator_t* me)
+{
+    // A drop of decodes, compared to the previous slots, may be stations outside of the window
+    bool drop = (me->num_slots > 0) && (me->num_decodes < me->cfg.drop_ratio * me->mean_decodes);
+    me->mean_decodes = (me->num_slots > 0) ? (me->cfg.decay * me->mean_decodes + (1 - me->cfg.decay) * me->num_decodes) : me->num_decodes;
+    ++me->num_slots;
+    me->num_decodes = 0;
+
+    if (me->weight > 0)
+    {
+        me->center = (find_quantile(me, 0.5f) + DT_ESTIMATOR_OFFSET_MIN + 0.5f) * me->cfg.symbol_period;
+    }
+
+    // Window of the next slot, unless widened after a drop (not twice in a row, so that it can narrow again)
+    me->widened = drop && !me->widened;
+    if (me->widened || (me->weight < me->cfg.min_weight))
+    {
+        set_full_window(me);
+    }
+    else
+    {
+        int first = find_quantile(me, (1 - me->cfg.coverage) / 2) - me->cfg.margin;
+        int last = find_quantile(me, (1 + me->cfg.coverage) / 2) + me->cfg.margin;
+        me->time_offset_min = (first > 0) ? (first + DT_ESTIMATOR_OFFSET_MIN) : DT_ESTIMATOR_OFFSET_MIN;
+        me->time_offset_max = (last < DT_ESTIMATOR_NUM_OFFSETS) ? (last + DT_ESTIMATOR_OFFSET_MIN) : (DT_ESTIMATOR_OFFSET_MIN + DT_ESTIMATOR_NUM_OFFSETS - 1);
+    }
+
+    // Older slots weigh less
+    for (int idx = 0; idx < DT_ESTIMATOR_NUM_OFFSETS; ++idx)
+    {
+        me->histogram[idx] *= me->cfg.decay;
+    }
+    me->weight *= me->cfg.decay;
+}
+
+int dt_estimator_recenter(dt_estimator_t* me, float target)
+{
+    if (me->weight < me->cfg.min_weight)
+        return 0;
+    int shift = (int)lroundf((me->center - target) / me->cfg.symbol_period);
+    if (shift == 0)
+        return 0;
+
+    // Decodes move by -shift blocks in the waterfall, those moved out of the histogram are dropped
+    float moved[DT_ESTIMATOR_NUM_OFFSETS];
+    me->weight = 0;
+    for (int idx = 0; idx < DT_ESTIMATOR_NUM_OFFSETS; ++idx)
+    {
+        int from = idx + shift;
+        moved[idx] = ((from >= 0) && (from < DT_ESTIMATOR_NUM_OFFSETS)) ? me->histogram[from] : 0;
+        me->weight += moved[idx];
+    }
+    for (int idx = 0; idx < DT_ESTIMATOR_NUM_OFFSETS; ++idx)
+    {
+        me->histogram[idx] = moved[idx];
+    }
+    me->center -= shift * me->cfg.symbol_period;
+
+    // Keep the window over the same decodes
+    if (!me->widened && (me->time_offset_max - me->time_offset_min + 1 < DT_ESTIMATOR_NUM_OFFSETS))
+    {
+        me->time_offset_min -= shift;
+        me->time_offset_max -= shift;
+        if (me->time_offset_min < DT_ESTIMATOR_OFFSET_MIN)
+            me->time_offset_min = DT_ESTIMATOR_OFFSET_MIN;
+        if (me->time_offset_max > DT_ESTIMATOR_OFFSET_MIN + DT_ESTIMATOR_NUM_OFFSETS - 1)
+            me->time_offset_max = DT_ESTIMATOR_OFFSET_MIN + DT_ESTIMATOR_NUM_OFFSETS - 1;
+        if (me->time_offset_min > me->time_offset_max)
+            set_full_window(me);
+    }
+    return shift;
+}
@@ -0,0 +1,65 @@
+#ifndef _INCLUDE_DT_ESTIMATOR_H_
+#define _INCLUDE_DT_ESTIMATOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+
+/// Time offsets tracked by the estimator, in blocks: the range searched by ftx_find_candidates() (-10 .. 19)
+#define DT_ESTIMATOR_OFFSET_MIN (-10)
+#define DT_ESTIMATOR_NUM_OFFSETS 30
+
+/// Configuration of the DT window estimator
+typedef struct
+{
+    float symbol_period; ///< Symbol period (block duration) in seconds
+    float decay;         ///< Weight of the past slots, applied once per slot (e.g. 0.75)
+    float coverage;      ///< Fraction of the recent decodes within the window before the margin (e.g. 0.98)
+    int margin;          ///< Blocks added on both sides of the window
+    float min_weight;    ///< Decayed number of decodes needed to narrow the window
+    float drop_ratio;    ///< The window is widened for a slot after decoding less than this fraction of the average
+} dt_estimator_config_t;
+
+/// Online estimate of the distribution of the time offsets (DT) of the decoded messages. Stations are mostly
+/// within a few hundred milliseconds of each other, so the candidate search can be narrowed to the time offsets
+/// where messages were decoded in the recent slots, with a margin, and the slot alignment re-centered on them.
+/// All fields are state of the estimator, exposed for monitoring.
+typedef struct
+{
+    dt_estimator_config_t cfg;
+    float histogram[DT_ESTIMATOR_NUM_OFFSETS]; ///< Decayed number of decodes by time offset (from DT_ESTIMATOR_OFFSET_MIN)
+    float weight;                              ///< Decayed number of decodes (sum of the histogram)
+    float mean_decodes;                        ///< Average number of decodes per slot
+    int num_slots;                             ///< Number of slots ended
+    int num_decodes;                           ///< Number of decodes in the current slot
+    float center;                              ///< Median time offset of the recent decodes in seconds
+    bool widened;                              ///< The window of the current slot is widened after a drop of decodes
+    int time_offset_min;                       ///< First time offset of the window of the current slot, in blocks
+    int time_offset_max;                       ///< Last time offset of the window of the current slot, in blocks
+} dt_estimator_t;
+
+/// Initialize the estimator with the full window of time offsets
+void dt_estimator_init(dt_estimator_t* me, const dt_estimator_config_t* cfg);
+
+/// Record the time offset (in seconds, from the start of the waterfall) of a message decoded in the current slot
+void dt_estimator_add(dt_estimator_t* me, float time);
+
+/// End the current slot: update the distribution, then choose the window of the next slot. The window covers
+/// cfg.coverage of the recent decodes with cfg.margin blocks on both sides, or all time offsets while there are
+/// not enough decodes yet, and for one slot after a slot with a drop of decodes.
+void dt_estimator_end_slot(dt_estimator_t* me);
+
+/// Re-center the slot alignment: the number of whole blocks from the target time offset (in seconds) to the median
+/// time offset of the recent decodes. The distribution and the window are moved by as many blocks, so the caller
+/// is expected to start the next waterfalls that many symbol periods later (earlier if negative).
+/// @return Number of blocks the alignment is moved (0 while there are not enough decodes)
+int dt_estimator_recenter(dt_estimator_t* me, float target);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _INCLUDE_DT_ESTIMATOR_H_
@@ -5,6 +5,16 @@
 #include <ft8/debug.h>
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 static float hann_i(int i, int N)
 {
@@ -34,25 +44,384 @@ static float hann_i(int i, int N)
 //     return a0 - a1 * x1 + a2 * x2;
 // }
 
-static void waterfall_init(ftx_waterfall_t* me, int max_blocks, int num_bins, int time_osr, int freq_osr)
+#ifndef WATERFALL_USE_PHASE
+
+// Waterfall magnitude code = 2 * 10 * log10(power) + 240 = QUANT_SCALE * log2(power) + 240
+#define QUANT_SCALE (6.0206f) // 20 / log2(10)
+// Estimates this close to a code boundary are recomputed with the exact scalar conversion
+#define QUANT_MARGIN (0.002f)
+
+// Reference conversion of a single bin power to a waterfall magnitude code (0.5 dB steps, 0 = -120 dB)
+static uint8_t quantize_power(float power)
+{
+    float db = 10.0f * log10f(power);
+    // Scale decibels to unsigned 8-bit range and clamp the value
+    // Range 0-240 covers -120..0 dB in 0.5 dB steps
+    int scaled = (int)(2 * db + 240);
+    return (scaled < 0) ? 0 : ((scaled > 255) ? 255 : scaled);
+}
+
+// Coefficients of log2(1 + t) ~ t * (c0 + c1*t + ... + c5*t^5) for sqrt(0.5) <= 1 + t < sqrt(2),
+// max absolute error ~4e-6 (about 2.5e-5 of a magnitude code)
+#define LOG2_C0 (1.44270044f)
+#define LOG2_C1 (-0.721195752f)
+#define LOG2_C2 (0.479925573f)
+#define LOG2_C3 (-0.366925771f)
+#define LOG2_C4 (0.316898187f)
+#define LOG2_C5 (-0.202289264f)
+
+#if defined(__SSE2__) || defined(__AVX2__)
+// Lanes with estimates too close to a code boundary are redone in scalar code
+static void quantize_fixup(const float* power, int mask, int num_lanes, uint8_t* mag)
+{
+    for (int lane = 0; lane < num_lanes; ++lane)
+    {
+        if (mask & (1 << lane))
+            mag[lane] = quantize_power(power[lane]);
+    }
+}
+#endif
+
+#if defined(__AVX2__)
+static __m256 log2_ps(__m256 x)
+{
+    __m256i bits = _mm256_castps_si256(x);
+    __m256i e = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x7FFFFF)), _mm256_set1_epi32(0x3F800000)));
+    // Bring the mantissa to [sqrt(0.5), sqrt(2)) for a symmetric polynomial range
+    __m256 big = _mm256_cmp_ps(m, _mm256_set1_ps(1.41421356f), _CMP_GE_OQ);
+    m = _mm256_blendv_ps(m, _mm256_mul_ps(m, _mm256_set1_ps(0.5f)), big);
+    e = _mm256_sub_epi32(e, _mm256_castps_si256(big)); // mask is -1 where true
+    __m256 t = _mm256_sub_ps(m, _mm256_set1_ps(1.0f));
+    __m256 p = _mm256_set1_ps(LOG2_C5);
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(LOG2_C4));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(LOG2_C3));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(LOG2_C2));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(LOG2_C1));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(LOG2_C0));
+    return _mm256_add_ps(_mm256_cvtepi32_ps(e), _mm256_mul_ps(p, t));
+}
+#elif defined(__SSE2__)
+static __m128 log2_ps(__m128 x)
+{
+    __m128i bits = _mm_castps_si128(x);
+    __m128i e = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x7FFFFF)), _mm_set1_epi32(0x3F800000)));
+    // Bring the mantissa to [sqrt(0.5), sqrt(2)) for a symmetric polynomial range
+    __m128 big = _mm_cmpge_ps(m, _mm_set1_ps(1.41421356f));
+    m = _mm_or_ps(_mm_andnot_ps(big, m), _mm_and_ps(big, _mm_mul_ps(m, _mm_set1_ps(0.5f))));
+    e = _mm_sub_epi32(e, _mm_castps_si128(big)); // mask is -1 where true
+    __m128 t = _mm_sub_ps(m, _mm_set1_ps(1.0f));
+    __m128 p = _mm_set1_ps(LOG2_C5);
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(LOG2_C4));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(LOG2_C3));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(LOG2_C2));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(LOG2_C1));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(LOG2_C0));
+    return _mm_add_ps(_mm_cvtepi32_ps(e), _mm_mul_ps(p, t));
+}
+#elif defined(__ARM_NEON)
+static float32x4_t log2_ps(float32x4_t x)
+{
+    int32x4_t bits = vreinterpretq_s32_f32(x);
+    int32x4_t e = vsubq_s32(vshrq_n_s32(bits, 23), vdupq_n_s32(127));
+    float32x4_t m = vreinterpretq_f32_s32(vorrq_s32(vandq_s32(bits, vdupq_n_s32(0x7FFFFF)), vdupq_n_s32(0x3F800000)));
+    // Bring the mantissa to [sqrt(0.5), sqrt(2)) for a symmetric polynomial range
+    uint32x4_t big = vcgeq_f32(m, vdupq_n_f32(1.41421356f));
+    m = vbslq_f32(big, vmulq_n_f32(m, 0.5f), m);
+    e = vsubq_s32(e, vreinterpretq_s32_u32(big)); // mask is -1 where true
+    float32x4_t t = vsubq_f32(m, vdupq_n_f32(1.0f));
+    float32x4_t p = vdupq_n_f32(LOG2_C5);
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(LOG2_C4));
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(LOG2_C3));
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(LOG2_C2));
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(LOG2_C1));
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(LOG2_C0));
+    return vaddq_f32(vcvtq_f32_s32(e), vmulq_f32(p, t));
+}
+#endif
+
+float monitor_quantize_mag(const kiss_fft_cpx* freqdata, int num_bins, uint8_t* mag)
+{
+    float max_power = 1E-12f;
+    int bin = 0;
+
+#if defined(__AVX2__)
+    __m256 vmax = _mm256_set1_ps(max_power);
+    for (; bin + 8 <= num_bins; bin += 8)
+    {
+        // Deinterleave (re, im) pairs and compute power of 8 bins
+        __m256 a = _mm256_loadu_ps(&freqdata[bin].r);
+        __m256 b = _mm256_loadu_ps(&freqdata[bin + 4].r);
+        a = _mm256_mul_ps(a, a);
+        b = _mm256_mul_ps(b, b);
+        __m256 re2 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 im2 = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        // shuffle_ps works within 128-bit lanes, restore the bin order
+        re2 = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(re2), _MM_SHUFFLE(3, 1, 2, 0)));
+        im2 = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(im2), _MM_SHUFFLE(3, 1, 2, 0)));
+        __m256 power = _mm256_add_ps(_mm256_set1_ps(1E-12f), _mm256_add_ps(im2, re2));
+        vmax = _mm256_max_ps(vmax, power);
+
+        __m256 est = _mm256_add_ps(_mm256_mul_ps(log2_ps(power), _mm256_set1_ps(QUANT_SCALE)), _mm256_set1_ps(240.0f));
+        est = _mm256_min_ps(_mm256_max_ps(est, _mm256_set1_ps(0.0f)), _mm256_set1_ps(256.5f));
+        __m256i code = _mm256_cvttps_epi32(est);
+        __m256 frac = _mm256_sub_ps(est, _mm256_cvtepi32_ps(code));
+        __m256 near = _mm256_or_ps(_mm256_cmp_ps(frac, _mm256_set1_ps(QUANT_MARGIN), _CMP_LT_OQ),
+            _mm256_cmp_ps(frac, _mm256_set1_ps(1.0f - QUANT_MARGIN), _CMP_GT_OQ));
+        near = _mm256_and_ps(near, _mm256_cmp_ps(est, _mm256_set1_ps(0.5f), _CMP_GT_OQ));
+        near = _mm256_and_ps(near, _mm256_cmp_ps(est, _mm256_set1_ps(255.5f), _CMP_LT_OQ));
+
+        __m128i code16 = _mm_packs_epi32(_mm256_castsi256_si128(code), _mm256_extracti128_si256(code, 1));
+        _mm_storel_epi64((__m128i*)(mag + bin), _mm_packus_epi16(code16, code16));
+
+        int mask = _mm256_movemask_ps(near);
+        if (mask)
+        {
+            float power_lanes[8];
+            _mm256_storeu_ps(power_lanes, power);
+            quantize_fixup(power_lanes, mask, 8, mag + bin);
+        }
+    }
+    float max_lanes[8];
+    _mm256_storeu_ps(max_lanes, vmax);
+    for (int lane = 0; lane < 8; ++lane)
+    {
+        if (max_lanes[lane] > max_power)
+            max_power = max_lanes[lane];
+    }
+#elif defined(__SSE2__)
+    __m128 vmax = _mm_set1_ps(max_power);
+    for (; bin + 4 <= num_bins; bin += 4)
+    {
+        // Deinterleave (re, im) pairs and compute power of 4 bins
+        __m128 a = _mm_loadu_ps(&freqdata[bin].r);
+        __m128 b = _mm_loadu_ps(&freqdata[bin + 2].r);
+        a = _mm_mul_ps(a, a);
+        b = _mm_mul_ps(b, b);
+        __m128 re2 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 im2 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 power = _mm_add_ps(_mm_set1_ps(1E-12f), _mm_add_ps(im2, re2));
+        vmax = _mm_max_ps(vmax, power);
+
+        __m128 est = _mm_add_ps(_mm_mul_ps(log2_ps(power), _mm_set1_ps(QUANT_SCALE)), _mm_set1_ps(240.0f));
+        est = _mm_min_ps(_mm_max_ps(est, _mm_set1_ps(0.0f)), _mm_set1_ps(256.5f));
+        __m128i code = _mm_cvttps_epi32(est);
+        __m128 frac = _mm_sub_ps(est, _mm_cvtepi32_ps(code));
+        __m128 near = _mm_or_ps(_mm_cmplt_ps(frac, _mm_set1_ps(QUANT_MARGIN)), _mm_cmpgt_ps(frac, _mm_set1_ps(1.0f - QUANT_MARGIN)));
+        near = _mm_and_ps(near, _mm_cmpgt_ps(est, _mm_set1_ps(0.5f)));
+        near = _mm_and_ps(near, _mm_cmplt_ps(est, _mm_set1_ps(255.5f)));
+
+        __m128i code16 = _mm_packs_epi32(code, code);
+        *(int32_t*)(mag + bin) = _mm_cvtsi128_si32(_mm_packus_epi16(code16, code16));
+
+        int mask = _mm_movemask_ps(near);
+        if (mask)
+        {
+            float power_lanes[4];
+            _mm_storeu_ps(power_lanes, power);
+            quantize_fixup(power_lanes, mask, 4, mag + bin);
+        }
+    }
+    float max_lanes[4];
+    _mm_storeu_ps(max_lanes, vmax);
+    for (int lane = 0; lane < 4; ++lane)
+    {
+        if (max_lanes[lane] > max_power)
+            max_power = max_lanes[lane];
+    }
+#elif defined(__ARM_NEON)
+    float32x4_t vmax = vdupq_n_f32(max_power);
+    for (; bin + 4 <= num_bins; bin += 4)
+    {
+        // Deinterleave (re, im) pairs and compute power of 4 bins
+        float32x4x2_t x = vld2q_f32(&freqdata[bin].r);
+        float32x4_t power = vaddq_f32(vmulq_f32(x.val[1], x.val[1]), vmulq_f32(x.val[0], x.val[0]));
+        power = vaddq_f32(vdupq_n_f32(1E-12f), power);
+        vmax = vmaxq_f32(vmax, power);
+
+        float32x4_t est = vaddq_f32(vmulq_n_f32(log2_ps(power), QUANT_SCALE), vdupq_n_f32(240.0f));
+        est = vminq_f32(vmaxq_f32(est, vdupq_n_f32(0.0f)), vdupq_n_f32(256.5f));
+        int32x4_t code = vcvtq_s32_f32(est);
+        float32x4_t frac = vsubq_f32(est, vcvtq_f32_s32(code));
+        uint32x4_t near = vorrq_u32(vcltq_f32(frac, vdupq_n_f32(QUANT_MARGIN)), vcgtq_f32(frac, vdupq_n_f32(1.0f - QUANT_MARGIN)));
+        near = vandq_u32(near, vcgtq_f32(est, vdupq_n_f32(0.5f)));
+        near = vandq_u32(near, vcltq_f32(est, vdupq_n_f32(255.5f)));
+
+        uint16x4_t code16 = vqmovun_s32(code);
+        uint8x8_t code8 = vqmovn_u16(vcombine_u16(code16, code16));
+        vst1_lane_u32((uint32_t*)(mag + bin), vreinterpret_u32_u8(code8), 0);
+
+        uint32_t near_lanes[4];
+        vst1q_u32(near_lanes, near);
+        if (near_lanes[0] | near_lanes[1] | near_lanes[2] | near_lanes[3])
+        {
+            float power_lanes[4];
+            vst1q_f32(power_lanes, power);
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                if (near_lanes[lane])
+                    mag[bin + lane] = quantize_power(power_lanes[lane]);
+            }
+        }
+    }
+    float32x2_t vmax2 = vpmax_f32(vget_low_f32(vmax), vget_high_f32(vmax));
+    vmax2 = vpmax_f32(vmax2, vmax2);
+    if (vget_lane_f32(vmax2, 0) > max_power)
+        max_power = vget_lane_f32(vmax2, 0);
+#endif
+
+    // Remaining bins (or all of them without SIMD support)
+    for (; bin < num_bins; ++bin)
+    {
+        float power = 1E-12f + ((freqdata[bin].i * freqdata[bin].i) + (freqdata[bin].r * freqdata[bin].r));
+        mag[bin] = quantize_power(power);
+        if (power > max_power)
+            max_power = power;
+    }
+
+    return max_power;
+}
+
+#endif // !WATERFALL_USE_PHASE
+
+// Reserve a cache-aligned chunk of 'size' bytes at *pos and advance *pos past it
+static uintptr_t mem_reserve(uintptr_t* pos, size_t size)
+{
+    uintptr_t addr = (*pos + (MONITOR_MEM_ALIGN - 1)) & ~(uintptr_t)(MONITOR_MEM_ALIGN - 1);
+    *pos = addr + size;
+    return addr;
+}
+
+static void waterfall_init(ftx_waterfall_t* me, int max_blocks, int num_bins, int time_osr, int freq_osr, ftx_waterfall_layout_t layout, ftx_waterfall_format_t format)
 {
-    size_t mag_size = max_blocks * time_osr * freq_osr * num_bins * sizeof(me->mag[0]);
     me->max_blocks = max_blocks;
     me->num_blocks = 0;
+    me->block_start = 0;
+    me->block_count = 0;
     me->num_bins = num_bins;
     me->time_osr = time_osr;
     me->freq_osr = freq_osr;
-    me->block_stride = (time_osr * freq_osr * num_bins);
-    me->mag = (WF_ELEM_T*)malloc(mag_size);
-    LOG(LOG_DEBUG, "Waterfall size = %zu\n", mag_size);
+    me->row_stride = (format == FTX_WATERFALL_FORMAT_U4) ? FTX_WATERFALL_U4_ROW_SIZE(num_bins) : num_bins;
+    me->block_stride = (time_osr * freq_osr * me->row_stride);
+    me->layout = layout;
+    me->format = format;
 }
 
-static void waterfall_free(ftx_waterfall_t* me)
+// Size of the mag array of a waterfall in bytes
+static size_t waterfall_mag_size(const ftx_waterfall_t* me)
 {
-    free(me->mag);
+    size_t size = me->max_blocks * me->block_stride * sizeof(me->mag[0]);
+    if (me->format == FTX_WATERFALL_FORMAT_U4)
+        size += FTX_WATERFALL_U4_PADDING;
+    return size;
 }
 
-void monitor_init(monitor_t* me, const monitor_config_t* cfg)
+// Recompute the sliding DFT state from scratch out of the samples in the analysis frame.
+// This removes any rounding error accumulated by the recursive updates.
+static void sdft_resync(monitor_t* me)
+{
+    double* state_re = me->sdft_state;
+    double* state_im = me->sdft_state + me->sdft_num_bins;
+    for (int idx = 0; idx < me->sdft_num_bins; ++idx)
+    {
+        // X[k] = sum x[m] * exp(-j*2*pi*k*m/N), with x[0] being the oldest sample
+        double w_re = me->sdft_twiddle[idx];
+        double w_im = -me->sdft_twiddle[me->sdft_num_bins + idx];
+        double rot_re = 1;
+        double rot_im = 0;
+        double sum_re = 0;
+        double sum_im = 0;
+        int pos = me->frame_head;
+        for (int m = 0; m < me->nfft; ++m)
+        {
+            if (me->iq_input)
+            {
+                sum_re += me->last_frame[2 * pos] * rot_re - me->last_frame[2 * pos + 1] * rot_im;
+                sum_im += me->last_frame[2 * pos] * rot_im + me->last_frame[2 * pos + 1] * rot_re;
+            }
+            else
+            {
+                sum_re += me->last_frame[pos] * rot_re;
+                sum_im += me->last_frame[pos] * rot_im;
+            }
+            double tmp = rot_re * w_re - rot_im * w_im;
+            rot_im = rot_re * w_im + rot_im * w_re;
+            rot_re = tmp;
+            if (++pos == me->nfft)
+                pos = 0;
+        }
+        state_re[idx] = sum_re;
+        state_im[idx] = sum_im;
+    }
+}
+
+static void sdft_init(monitor_t* me)
+{
+    me->frame_head = 0;
+    for (int idx = 0; idx < 2 * me->sdft_num_bins; ++idx)
+    {
+        me->sdft_state[idx] = 0;
+    }
+    for (int idx = 0; idx < me->sdft_num_bins; ++idx)
+    {
+        double phase = 2 * M_PI * (me->sdft_begin + idx) / me->nfft;
+        me->sdft_twiddle[idx] = cos(phase);
+        me->sdft_twiddle[me->sdft_num_bins + idx] = sin(phase);
+    }
+}
+
+// Slide the analysis frame by one subblock, updating the DFT of each tracked bin sample by sample:
+// X'[k] = (X[k] - x_old + x_new) * exp(j*2*pi*k/N)
+// Then apply the Hann window as a 3-tap kernel in frequency domain and output the band bins.
+static void sdft_process(monitor_t* me, const float* frame, kiss_fft_cpx* freqdata)
+{
+    const int num_bins = me->sdft_num_bins;
+    double* state_re = me->sdft_state;
+    double* state_im = me->sdft_state + num_bins;
+    const double* tw_re = me->sdft_twiddle;
+    const double* tw_im = me->sdft_twiddle + num_bins;
+
+    for (int pos = 0; pos < me->subblock_size; ++pos)
+    {
+        double delta_re, delta_im;
+        if (me->iq_input)
+        {
+            float* oldest = me->last_frame + 2 * me->frame_head;
+            delta_re = (double)frame[2 * pos] - oldest[0];
+            delta_im = (double)frame[2 * pos + 1] - oldest[1];
+            oldest[0] = frame[2 * pos];
+            oldest[1] = frame[2 * pos + 1];
+        }
+        else
+        {
+            delta_re = (double)frame[pos] - me->last_frame[me->frame_head];
+            delta_im = 0;
+            me->last_frame[me->frame_head] = frame[pos];
+        }
+        if (++me->frame_head == me->nfft)
+            me->frame_head = 0;
+
+        for (int idx = 0; idx < num_bins; ++idx)
+        {
+            double re = state_re[idx] + delta_re;
+            double im = state_im[idx] + delta_im;
+            state_re[idx] = re * tw_re[idx] - im * tw_im[idx];
+            state_im[idx] = re * tw_im[idx] + im * tw_re[idx];
+        }
+    }
+
+    // Periodic Hann window w[i] = sin^2(pi*i/N) = 0.5 - 0.25*exp(j*2*pi*i/N) - 0.25*exp(-j*2*pi*i/N)
+    for (int idx = 1; idx + 1 < num_bins; ++idx)
+    {
+        double re = 0.5 * state_re[idx] - 0.25 * (state_re[idx - 1] + state_re[idx + 1]);
+        double im = 0.5 * state_im[idx] - 0.25 * (state_im[idx - 1] + state_im[idx + 1]);
+        freqdata[idx - 1].r = (float)(me->fft_norm * re);
+        freqdata[idx - 1].i = (float)(me->fft_norm * im);
+    }
+}
+
+bool monitor_init_mem(monitor_t* me, const monitor_config_t* cfg, void* mem, size_t* lenmem)
 {
     float slot_time = (cfg->protocol == FTX_PROTOCOL_FT4) ? FT4_SLOT_TIME : FT8_SLOT_TIME;
     float symbol_period = (cfg->protocol == FTX_PROTOCOL_FT4) ? FT4_SYMBOL_PERIOD : FT8_SYMBOL_PERIOD;
@@ -61,9 +430,97 @@ void monitor_init(monitor_t* me, const monitor_config_t* cfg)
     me->subblock_size = me->block_size / cfg->time_osr;
     me->nfft = me->block_size * cfg->freq_osr;
     me->fft_norm = 2.0f / me->nfft;
+    me->iq_input = cfg->iq_input;
+    const int sample_floats = me->iq_input ? 2 : 1; // I/Q pairs with complex input
     // const int len_window = 1.8f * me->block_size; // hand-picked and optimized
 
-    me->window = (float*)malloc(me->nfft * sizeof(me->window[0]));
+    // Allocate enough blocks to fit the entire FT8/FT4 slot in memory (or all slots of a rolling waterfall)
+    me->ring = (cfg->ring_slots > 0);
+    const int max_blocks = me->ring ? (int)ceilf(cfg->ring_slots * slot_time / symbol_period) : (int)(slot_time / symbol_period);
+    // Keep only FFT bins in the specified frequency range (f_min/f_max)
+    me->min_bin = (int)floorf(cfg->f_min * symbol_period);
+    me->max_bin = (int)floorf(cfg->f_max * symbol_period) + 1;
+    const int num_bins = me->max_bin - me->min_bin;
+    const int band_size = num_bins * cfg->freq_osr;
+
+    me->engine = cfg->engine;
+    // Track one extra bin on each side of the band, needed for the frequency domain Hann window
+    me->sdft_begin = me->min_bin * cfg->freq_osr - 1;
+    me->sdft_num_bins = (me->engine == MONITOR_ENGINE_SDFT) ? (band_size + 2) : 0;
+
+    size_t fft_work_size = 0;
+    if (me->iq_input)
+        kiss_fft_alloc(me->nfft, 0, NULL, &fft_work_size);
+    else
+        kiss_fftr_alloc(me->nfft, 0, NULL, &fft_work_size);
+#ifdef WATERFALL_USE_PHASE
+    me->nifft = 64; // Gives 200 Hz sample rate for FT8 (160ms symbol period)
+    size_t ifft_work_size = 0;
+    kiss_fft_alloc(me->nifft, 1, NULL, &ifft_work_size);
+#endif
+#ifdef WATERFALL_USE_PHASE
+    waterfall_init(&me->wf, max_blocks, num_bins, cfg->time_osr, cfg->freq_osr, cfg->wf_layout, FTX_WATERFALL_FORMAT_U8);
+#else
+    waterfall_init(&me->wf, max_blocks, num_bins, cfg->time_osr, cfg->freq_osr, cfg->wf_layout, cfg->wf_format);
+#endif
+    me->wf.protocol = cfg->protocol;
+    size_t mag_size = waterfall_mag_size(&me->wf);
+
+    // Lay out all buffers in one block, starting at a cache-aligned address
+    uintptr_t base = ((uintptr_t)mem + (MONITOR_MEM_ALIGN - 1)) & ~(uintptr_t)(MONITOR_MEM_ALIGN - 1);
+    uintptr_t pos = base;
+    uintptr_t addr_window = mem_reserve(&pos, me->nfft * sizeof(me->window[0]));
+    uintptr_t addr_last_frame = mem_reserve(&pos, sample_floats * me->nfft * sizeof(me->last_frame[0]));
+    uintptr_t addr_timedata = mem_reserve(&pos, sample_floats * me->nfft * sizeof(me->timedata[0]));
+    uintptr_t addr_freqdata = mem_reserve(&pos, band_size * sizeof(me->freqdata[0]));
+    uintptr_t addr_spectrum = mem_reserve(&pos, me->iq_input ? (me->nfft * sizeof(me->spectrum[0])) : 0);
+#ifndef WATERFALL_USE_PHASE
+    uintptr_t addr_band_mag = mem_reserve(&pos, band_size * sizeof(me->band_mag[0]));
+#endif
+    uintptr_t addr_sdft_state = mem_reserve(&pos, 2 * me->sdft_num_bins * sizeof(me->sdft_state[0]));
+    uintptr_t addr_sdft_twiddle = mem_reserve(&pos, 2 * me->sdft_num_bins * sizeof(me->sdft_twiddle[0]));
+    uintptr_t addr_fft_work = mem_reserve(&pos, fft_work_size);
+#ifdef WATERFALL_USE_PHASE
+    uintptr_t addr_ifft_work = mem_reserve(&pos, ifft_work_size);
+#endif
+    uintptr_t addr_mag = mem_reserve(&pos, mag_size);
+    // Account for the worst case alignment of the block itself
+    size_t memneeded = (pos - base) + (MONITOR_MEM_ALIGN - 1);
+
+
+    me->mem = NULL;
+    if (lenmem == NULL)
+    {
+        // Allocate the block ourselves and redo the layout in it
+        size_t size = 0;
+        monitor_init_mem(me, cfg, NULL, &size);
+        void* block = malloc(size);
+        if ((block == NULL) || !monitor_init_mem(me, cfg, block, &size))
+        {
+            free(block);
+            return false;
+        }
+        me->mem = block;
+        return true;
+    }
+    bool fits = (mem != NULL) && (*lenmem >= memneeded);
+    *lenmem = memneeded;
+    if (!fits)
+        return false;
+
+    me->window = (float*)addr_window;
+    me->last_frame = (float*)addr_last_frame;
+    me->timedata = (kiss_fft_scalar*)addr_timedata;
+    me->freqdata = (kiss_fft_cpx*)addr_freqdata;
+    me->spectrum = me->iq_input ? (kiss_fft_cpx*)addr_spectrum : NULL;
+#ifndef WATERFALL_USE_PHASE
+    me->band_mag = (uint8_t*)addr_band_mag;
+#endif
+    me->sdft_state = (double*)addr_sdft_state;
+    me->sdft_twiddle = (double*)addr_sdft_twiddle;
+    me->fft_work = (void*)addr_fft_work;
+    me->wf.mag = (WF_ELEM_T*)addr_mag;
+
     for (int i = 0; i < me->nfft; ++i)
     {
         // window[i] = 1;
@@ -72,123 +529,409 @@ void monitor_init(monitor_t* me, const monitor_config_t* cfg)
         // me->window[i] = hamming_i(i, me->nfft);
         // me->window[i] = (i < len_window) ? hann_i(i, len_window) : 0;
     }
-    me->last_frame = (float*)calloc(me->nfft, sizeof(me->last_frame[0]));
+    for (int i = 0; i < sample_floats * me->nfft; ++i)
+    {
+        me->last_frame[i] = 0;
+    }
 
     LOG(LOG_INFO, "Block size = %d\n", me->block_size);
     LOG(LOG_INFO, "Subblock size = %d\n", me->subblock_size);
 
-    size_t fft_work_size = 0;
-    kiss_fftr_alloc(me->nfft, 0, 0, &fft_work_size);
-    me->fft_work = malloc(fft_work_size);
-    me->fft_cfg = kiss_fftr_alloc(me->nfft, 0, me->fft_work, &fft_work_size);
+    if (me->iq_input)
+    {
+        me->fft_cfg = NULL;
+        me->cfft_cfg = kiss_fft_alloc(me->nfft, 0, me->fft_work, &fft_work_size);
+    }
+    else
+    {
+        me->fft_cfg = kiss_fftr_alloc(me->nfft, 0, me->fft_work, &fft_work_size);
+        me->cfft_cfg = NULL;
+    }
 
     LOG(LOG_INFO, "N_FFT = %d\n", me->nfft);
     LOG(LOG_DEBUG, "FFT work area = %zu\n", fft_work_size);
 
 #ifdef WATERFALL_USE_PHASE
-    me->nifft = 64; // Gives 200 Hz sample rate for FT8 (160ms symbol period)
-
-    size_t ifft_work_size = 0;
-    kiss_fft_alloc(me->nifft, 1, 0, &ifft_work_size);
-    me->ifft_work = malloc(ifft_work_size);
+    me->ifft_work = (void*)addr_ifft_work;
     me->ifft_cfg = kiss_fft_alloc(me->nifft, 1, me->ifft_work, &ifft_work_size);
 
     LOG(LOG_INFO, "N_iFFT = %d\n", me->nifft);
     LOG(LOG_DEBUG, "iFFT work area = %zu\n", ifft_work_size);
 #endif
 
-    // Allocate enough blocks to fit the entire FT8/FT4 slot in memory
-    const int max_blocks = (int)(slot_time / symbol_period);
-    // Keep only FFT bins in the specified frequency range (f_min/f_max)
-    me->min_bin = (int)(cfg->f_min * symbol_period);
-    me->max_bin = (int)(cfg->f_max * symbol_period) + 1;
-    const int num_bins = me->max_bin - me->min_bin;
+    LOG(LOG_DEBUG, "Waterfall size = %zu\n", mag_size);
+    LOG(LOG_DEBUG, "Monitor memory = %zu\n", memneeded);
 
-    waterfall_init(&me->wf, max_blocks, num_bins, cfg->time_osr, cfg->freq_osr);
-    me->wf.protocol = cfg->protocol;
+    if (me->engine == MONITOR_ENGINE_SDFT)
+    {
+        sdft_init(me);
+    }
 
     me->symbol_period = symbol_period;
+    me->block_callback = NULL;
+    me->block_callback_ctx = NULL;
 
     me->max_mag = -120.0f;
+    return true;
+}
+
+void monitor_init(monitor_t* me, const monitor_config_t* cfg)
+{
+    monitor_init_mem(me, cfg, NULL, NULL);
 }
 
 void monitor_free(monitor_t* me)
 {
-    waterfall_free(&me->wf);
-    free(me->fft_work);
-    free(me->last_frame);
-    free(me->window);
+    // Only the block allocated by monitor_init() is owned by the monitor
+    free(me->mem);
+    me->mem = NULL;
 }
 
 void monitor_reset(monitor_t* me)
 {
     me->wf.num_blocks = 0;
+    me->wf.block_start = 0;
+    me->wf.block_count = 0;
     me->max_mag = -120.0f;
+
+    if (me->engine == MONITOR_ENGINE_SDFT)
+    {
+        // Discard the rounding error accumulated during the previous slot
+        sdft_resync(me);
+    }
+}
+
+// Shift one subblock of new samples into the analysis frame
+static void monitor_shift_frame(monitor_t* me, const float* frame)
+{
+    const int sample_floats = me->iq_input ? 2 : 1;
+    const int frame_size = sample_floats * me->nfft;
+    const int shift = sample_floats * me->subblock_size;
+    for (int pos = 0; pos < frame_size - shift; ++pos)
+    {
+        me->last_frame[pos] = me->last_frame[pos + shift];
+    }
+    for (int pos = 0; pos < shift; ++pos)
+    {
+        me->last_frame[frame_size - shift + pos] = frame[pos];
+    }
+}
+
+// Convert the spectrum of the analysis band to waterfall magnitudes for one time subdivision
+static void monitor_store_band(monitor_t* me, const kiss_fft_cpx* freqdata, int time_sub)
+{
+    const int band_begin = me->min_bin * me->wf.freq_osr;
+    int block = me->wf.block_count % me->wf.max_blocks;
+
+#ifdef WATERFALL_USE_PHASE
+    // Loop over possible frequency OSR offsets
+    for (int freq_sub = 0; freq_sub < me->wf.freq_osr; ++freq_sub)
+    {
+        WF_ELEM_T* row = ftx_waterfall_row(&me->wf, block, time_sub, freq_sub);
+        for (int bin = me->min_bin; bin < me->max_bin; ++bin)
+        {
+            int src_bin = (bin * me->wf.freq_osr) + freq_sub - band_begin;
+            float mag2 = (freqdata[src_bin].i * freqdata[src_bin].i) + (freqdata[src_bin].r * freqdata[src_bin].r);
+            float db = 10.0f * log10f(1E-12f + mag2);
+
+            // Save the magnitude in dB and phase in radians
+            float phase = atan2f(freqdata[src_bin].i, freqdata[src_bin].r);
+            row[bin - me->min_bin].mag = db;
+            row[bin - me->min_bin].phase = phase;
+
+            if (db > me->max_mag)
+                me->max_mag = db;
+        }
+    }
+#else
+    // Convert the whole band at once, then reorder bins by frequency OSR offset
+    const int band_end = me->max_bin * me->wf.freq_osr;
+    uint8_t* band_mag = me->band_mag;
+    float max_power = monitor_quantize_mag(freqdata, band_end - band_begin, band_mag);
+    float db = 10.0f * log10f(max_power);
+    if (db > me->max_mag)
+        me->max_mag = db;
+
+    for (int freq_sub = 0; freq_sub < me->wf.freq_osr; ++freq_sub)
+    {
+        ftx_waterfall_store_row(&me->wf, block, time_sub, freq_sub, band_mag + freq_sub, me->wf.freq_osr);
+    }
+#endif
+}
+
+// Check if we can still store more waterfall data
+static bool monitor_has_space(const monitor_t* me)
+{
+    return me->ring || (me->wf.block_count < me->wf.max_blocks);
+}
+
+// Account for a newly stored block and extend the view up to it
+static void monitor_advance(monitor_t* me)
+{
+    ftx_waterfall_t* wf = &me->wf;
+    ++wf->block_count;
+    if (wf->block_start < wf->block_count - wf->max_blocks)
+        wf->block_start = wf->block_count - wf->max_blocks;
+    wf->num_blocks = wf->block_count - wf->block_start;
+
+    if (me->block_callback != NULL)
+        me->block_callback(me->block_callback_ctx, wf);
 }
 
 // Compute FFT magnitudes (log wf) for a frame in the signal and update waterfall data
 void monitor_process(monitor_t* me, const float* frame)
 {
-    // Check if we can still store more waterfall data
-    if (me->wf.num_blocks >= me->wf.max_blocks)
+    if (!monitor_has_space(me))
         return;
 
-    int offset = me->wf.num_blocks * me->wf.block_stride;
-    int frame_pos = 0;
+    // Only the FFT bins within [min_bin, max_bin) (in terms of tone spacing) end up in the waterfall
+    const int band_begin = me->min_bin * me->wf.freq_osr;
+    const int band_end = me->max_bin * me->wf.freq_osr;
 
     // Loop over block subdivisions
     for (int time_sub = 0; time_sub < me->wf.time_osr; ++time_sub)
     {
-        kiss_fft_scalar timedata[me->nfft];
-        kiss_fft_cpx freqdata[me->nfft / 2 + 1];
+        const float* subblock = frame + time_sub * me->subblock_size * (me->iq_input ? 2 : 1);
+
+        if (me->engine == MONITOR_ENGINE_SDFT)
+        {
+            sdft_process(me, subblock, me->freqdata);
+        }
+        else if (me->iq_input)
+        {
+            monitor_shift_frame(me, subblock);
+
+            // Do complex DFT of windowed analysis frame
+            kiss_fft_cpx* timedata = (kiss_fft_cpx*)me->timedata;
+            for (int pos = 0; pos < me->nfft; ++pos)
+            {
+                timedata[pos].r = me->window[pos] * me->last_frame[2 * pos];
+                timedata[pos].i = me->window[pos] * me->last_frame[2 * pos + 1];
+            }
+            kiss_fft(me->cfft_cfg, timedata, me->spectrum);
+
+            // Negative frequencies are found at the top of the spectrum
+            for (int bin = band_begin; bin < band_end; ++bin)
+            {
+                int src_bin = (bin < 0) ? (bin + me->nfft) : ((bin >= me->nfft) ? (bin - me->nfft) : bin);
+                me->freqdata[bin - band_begin] = me->spectrum[src_bin];
+            }
+        }
+        else
+        {
+            monitor_shift_frame(me, subblock);
+
+            // Do DFT of windowed analysis frame
+            for (int pos = 0; pos < me->nfft; ++pos)
+            {
+                me->timedata[pos] = me->window[pos] * me->last_frame[pos];
+            }
+            kiss_fftr_band(me->fft_cfg, me->timedata, me->freqdata, band_begin, band_end);
+        }
+
+        monitor_store_band(me, me->freqdata, time_sub);
+    }
+
+    monitor_advance(me);
+}
+
+bool monitor_multi_init_mem(monitor_multi_t* me, const monitor_config_t* cfg, int num_channels, void* mem, size_t* lenmem)
+{
+    // Query the layout of a single channel monitor
+    monitor_t proto;
+    size_t channel_size = 0;
+    monitor_init_mem(&proto, cfg, NULL, &channel_size);
+    const int band_size = (proto.max_bin - proto.min_bin) * proto.wf.freq_osr;
+    size_t mag_size = waterfall_mag_size(&proto.wf);
+
+    me->num_channels = num_channels;
+    me->block_size = proto.block_size;
+    const int sample_floats = proto.iq_input ? 2 : 1;
+
+    // Batch four channels per transform with the 4-lane FFT when possible
+    size_t fft4_work_size = 0;
+#ifdef KISS_FFTR4_SUPPORTED
+    bool use_fft4 = (cfg->engine == MONITOR_ENGINE_FFT) && !cfg->iq_input && (num_channels >= 4);
+    if (use_fft4)
+        kiss_fftr4_alloc(proto.nfft, NULL, &fft4_work_size);
+#endif
+
+    // The first channel is a complete monitor, the others only get their own frame, SDFT state and waterfall
+    uintptr_t base = ((uintptr_t)mem + (MONITOR_MEM_ALIGN - 1)) & ~(uintptr_t)(MONITOR_MEM_ALIGN - 1);
+    uintptr_t pos = base;
+    uintptr_t addr_channels = mem_reserve(&pos, num_channels * sizeof(me->channels[0]));
+    uintptr_t addr_first = mem_reserve(&pos, channel_size);
+    uintptr_t addr_frames = mem_reserve(&pos, (size_t)num_channels * sample_floats * proto.block_size * sizeof(me->frames[0]));
+    uintptr_t addr_frame_ptrs = mem_reserve(&pos, num_channels * sizeof(me->frame_ptrs[0]));
+    uintptr_t addr_extra = pos;
+    for (int ch = 1; ch < num_channels; ++ch)
+    {
+        mem_reserve(&pos, sample_floats * proto.nfft * sizeof(proto.last_frame[0]));
+        mem_reserve(&pos, 2 * proto.sdft_num_bins * sizeof(proto.sdft_state[0]));
+        mem_reserve(&pos, mag_size);
+    }
+#ifdef KISS_FFTR4_SUPPORTED
+    uintptr_t addr_timedata4 = mem_reserve(&pos, use_fft4 ? (4 * proto.nfft * sizeof(me->timedata4[0])) : 0);
+    uintptr_t addr_freqdata4 = mem_reserve(&pos, use_fft4 ? (8 * band_size * sizeof(me->freqdata4[0])) : 0);
+    uintptr_t addr_fft4_work = mem_reserve(&pos, fft4_work_size);
+#endif
+    size_t memneeded = (pos - base) + (MONITOR_MEM_ALIGN - 1);
+
+    me->mem = NULL;
+    if (lenmem == NULL)
+    {
+        // Allocate the block ourselves and redo the layout in it
+        size_t size = 0;
+        monitor_multi_init_mem(me, cfg, num_channels, NULL, &size);
+        void* block = malloc(size);
+        if ((block == NULL) || !monitor_multi_init_mem(me, cfg, num_channels, block, &size))
+        {
+            free(block);
+            return false;
+        }
+        me->mem = block;
+        return true;
+    }
+    bool fits = (mem != NULL) && (num_channels > 0) && (*lenmem >= memneeded);
+    *lenmem = memneeded;
+    if (!fits)
+        return false;
+
+    me->channels = (monitor_t*)addr_channels;
+    me->frames = (float*)addr_frames;
+    me->frame_ptrs = (const float**)addr_frame_ptrs;
+    for (int ch = 0; ch < num_channels; ++ch)
+    {
+        me->frame_ptrs[ch] = me->frames + ch * sample_floats * proto.block_size;
+    }
+    if (!monitor_init_mem(&me->channels[0], cfg, (void*)addr_first, &channel_size))
+        return false;
 
-        // Shift the new data into analysis frame
-        for (int pos = 0; pos < me->nfft - me->subblock_size; ++pos)
+    // Other channels share the window, FFT plan and scratch buffers of the first one
+    pos = addr_extra;
+    for (int ch = 1; ch < num_channels; ++ch)
+    {
+        monitor_t* channel = &me->channels[ch];
+        *channel = me->channels[0];
+        channel->last_frame = (float*)mem_reserve(&pos, sample_floats * proto.nfft * sizeof(proto.last_frame[0]));
+        channel->sdft_state = (double*)mem_reserve(&pos, 2 * proto.sdft_num_bins * sizeof(proto.sdft_state[0]));
+        channel->wf.mag = (WF_ELEM_T*)mem_reserve(&pos, mag_size);
+        channel->mem = NULL;
+        for (int i = 0; i < sample_floats * channel->nfft; ++i)
         {
-            me->last_frame[pos] = me->last_frame[pos + me->subblock_size];
+            channel->last_frame[i] = 0;
         }
-        for (int pos = me->nfft - me->subblock_size; pos < me->nfft; ++pos)
+        for (int i = 0; i < 2 * channel->sdft_num_bins; ++i)
         {
-            me->last_frame[pos] = frame[frame_pos];
-            ++frame_pos;
+            channel->sdft_state[i] = 0;
         }
+    }
 
-        // Do DFT of windowed analysis frame
-        for (int pos = 0; pos < me->nfft; ++pos)
+#ifdef KISS_FFTR4_SUPPORTED
+    me->timedata4 = (float*)addr_timedata4;
+    me->freqdata4 = (float*)addr_freqdata4;
+    me->fft4_cfg = use_fft4 ? kiss_fftr4_alloc(proto.nfft, (void*)addr_fft4_work, &fft4_work_size) : NULL;
+#endif
+    LOG(LOG_DEBUG, "Multi-channel monitor memory = %zu\n", memneeded);
+    return true;
+}
+
+void monitor_multi_init(monitor_multi_t* me, const monitor_config_t* cfg, int num_channels)
+{
+    monitor_multi_init_mem(me, cfg, num_channels, NULL, NULL);
+}
+
+void monitor_multi_free(monitor_multi_t* me)
+{
+    free(me->mem);
+    me->mem = NULL;
+}
+
+void monitor_multi_reset(monitor_multi_t* me)
+{
+    for (int ch = 0; ch < me->num_channels; ++ch)
+    {
+        monitor_reset(&me->channels[ch]);
+    }
+}
+
+#ifdef KISS_FFTR4_SUPPORTED
+// Process four channels at once, one per SIMD lane of the 4-channel FFT
+static void monitor_process4(monitor_multi_t* me, monitor_t* channels, const float* const frames[])
+{
+    if (!monitor_has_space(&channels[0]))
+        return;
+
+    const monitor_t* first = &channels[0];
+    const int band_begin = first->min_bin * first->wf.freq_osr;
+    const int band_end = first->max_bin * first->wf.freq_osr;
+    kiss_fft_cpx* freqdata = first->freqdata;
+
+    for (int time_sub = 0; time_sub < first->wf.time_osr; ++time_sub)
+    {
+        for (int lane = 0; lane < 4; ++lane)
         {
-            timedata[pos] = me->window[pos] * me->last_frame[pos];
+            monitor_t* channel = &channels[lane];
+            monitor_shift_frame(channel, frames[lane] + time_sub * channel->subblock_size);
+            for (int pos = 0; pos < channel->nfft; ++pos)
+            {
+                me->timedata4[4 * pos + lane] = channel->window[pos] * channel->last_frame[pos];
+            }
         }
-        kiss_fftr(me->fft_cfg, timedata, freqdata);
+        kiss_fftr4_band(me->fft4_cfg, me->timedata4, me->freqdata4, band_begin, band_end);
 
-        // Loop over possible frequency OSR offsets
-        for (int freq_sub = 0; freq_sub < me->wf.freq_osr; ++freq_sub)
+        for (int lane = 0; lane < 4; ++lane)
         {
-            for (int bin = me->min_bin; bin < me->max_bin; ++bin)
+            for (int idx = 0; idx < band_end - band_begin; ++idx)
             {
-                int src_bin = (bin * me->wf.freq_osr) + freq_sub;
-                float mag2 = (freqdata[src_bin].i * freqdata[src_bin].i) + (freqdata[src_bin].r * freqdata[src_bin].r);
-                float db = 10.0f * log10f(1E-12f + mag2);
+                freqdata[idx].r = me->freqdata4[8 * idx + lane];
+                freqdata[idx].i = me->freqdata4[8 * idx + 4 + lane];
+            }
+            monitor_store_band(&channels[lane], freqdata, time_sub);
+        }
+    }
 
-#ifdef WATERFALL_USE_PHASE
-                // Save the magnitude in dB and phase in radians
-                float phase = atan2f(freqdata[src_bin].i, freqdata[src_bin].r);
-                me->wf.mag[offset].mag = db;
-                me->wf.mag[offset].phase = phase;
-#else
-                // Scale decibels to unsigned 8-bit range and clamp the value
-                // Range 0-240 covers -120..0 dB in 0.5 dB steps
-                int scaled = (int)(2 * db + 240);
-                me->wf.mag[offset] = (scaled < 0) ? 0 : ((scaled > 255) ? 255 : scaled);
+    for (int lane = 0; lane < 4; ++lane)
+    {
+        monitor_advance(&channels[lane]);
+    }
+}
 #endif
-                ++offset;
 
-                if (db > me->max_mag)
-                    me->max_mag = db;
-            }
+void monitor_multi_process(monitor_multi_t* me, const float* const frames[])
+{
+    int ch = 0;
+#ifdef KISS_FFTR4_SUPPORTED
+    if (me->fft4_cfg != NULL)
+    {
+        for (; ch + 4 <= me->num_channels; ch += 4)
+        {
+            monitor_process4(me, &me->channels[ch], frames + ch);
         }
     }
+#endif
+    // Remaining channels (or all of them without the 4-channel FFT)
+    for (; ch < me->num_channels; ++ch)
+    {
+        monitor_process(&me->channels[ch], frames[ch]);
+    }
+}
 
-    ++me->wf.num_blocks;
+void monitor_multi_process_interleaved(monitor_multi_t* me, const float* frame)
+{
+    const int sample_floats = me->channels[0].iq_input ? 2 : 1;
+    for (int ch = 0; ch < me->num_channels; ++ch)
+    {
+        float* dst = me->frames + ch * sample_floats * me->block_size;
+        for (int pos = 0; pos < me->block_size; ++pos)
+        {
+            for (int k = 0; k < sample_floats; ++k)
+            {
+                dst[sample_floats * pos + k] = frame[sample_floats * (pos * me->num_channels + ch) + k];
+            }
+        }
+    }
+    monitor_multi_process(me, me->frame_ptrs);
 }
 
 #ifdef WATERFALL_USE_PHASE
@@ -199,14 +942,6 @@ void monitor_resynth(const monitor_t* me, const candidate_t* candidate, float* s
     const int taper_width = 4;
     const int num_tones = 8;
 
-    // Starting offset is 3 subblocks due to analysis buffer loading
-    int offset = 1;                          // candidate->time_offset;
-    offset = (offset * me->wf.time_osr) + 1; // + candidate->time_sub;
-    offset = (offset * me->wf.freq_osr);     // + candidate->freq_sub;
-    offset = (offset * me->wf.num_bins);     // + candidate->freq_offset;
-
-    WF_ELEM_T* el = me->wf.mag + offset;
-
     // DFT frequency data - initialize to zero
     kiss_fft_cpx freqdata[num_ifft];
     for (int i = 0; i < num_ifft; ++i)
@@ -218,6 +953,9 @@ void monitor_resynth(const monitor_t* me, const candidate_t* candidate, float* s
     int pos = 0;
     for (int num_block = 1; num_block < me->wf.num_blocks; ++num_block)
     {
+        // Starting offset is 3 subblocks due to analysis buffer loading
+        const WF_ELEM_T* el = ftx_waterfall_row(&me->wf, num_block, 1, 0);
+        const WF_ELEM_T* el_next = ftx_waterfall_row(&me->wf, num_block, 1, 1);
         // Extract frequency data around the selected candidate only
         for (int i = candidate->freq_offset - taper_width - 1; i < candidate->freq_offset + 8 + taper_width - 1; ++i)
         {
@@ -239,11 +977,10 @@ void monitor_resynth(const monitor_t* me, const candidate_t* candidate, float* s
                 freqdata[tgt_bin].r = mag * cosf(el[i].phase);
                 freqdata[tgt_bin].i = mag * sinf(el[i].phase);
 
-                int i2 = i + me->wf.num_bins;
                 tgt_bin = (tgt_bin + 1) % num_ifft;
-                float mag2 = powf(10.0f, el[i2].mag / 20) / 2 * weight;
-                freqdata[tgt_bin].r = mag2 * cosf(el[i2].phase);
-                freqdata[tgt_bin].i = mag2 * sinf(el[i2].phase);
+                float mag2 = powf(10.0f, el_next[i].mag / 20) / 2 * weight;
+                freqdata[tgt_bin].r = mag2 * cosf(el_next[i].phase);
+                freqdata[tgt_bin].i = mag2 * sinf(el_next[i].phase);
             }
         }
 
@@ -256,7 +993,6 @@ void monitor_resynth(const monitor_t* me, const candidate_t* candidate, float* s
         }
 
         // Move to the next symbol
-        el += me->wf.block_stride;
         pos += num_shift;
     }
 }
@@ -8,6 +8,17 @@ extern "C"
 
 #include <ft8/decode.h>
 #include <fft/kiss_fftr.h>
+#include <fft/kiss_fftr4.h>
+
+/// Alignment (in bytes) of the buffers placed in the monitor memory block
+#define MONITOR_MEM_ALIGN 64
+
+/// DSP engine used by the monitor to compute waterfall magnitudes
+typedef enum
+{
+    MONITOR_ENGINE_FFT, ///< Windowed real FFT of the whole analysis frame for every subblock (default)
+    MONITOR_ENGINE_SDFT ///< Sliding DFT updated sample by sample, only over the bins of interest
+} monitor_engine_t;
 
 /// Configuration options for FT4/FT8 monitor
 typedef struct
@@ -18,8 +29,18 @@ typedef struct
     int time_osr;            ///< Number of time subdivisions
     int freq_osr;            ///< Number of frequency subdivisions
     ftx_protocol_t protocol; ///< Protocol: FT4 or FT8
+    monitor_engine_t engine; ///< DSP engine (MONITOR_ENGINE_FFT if left zero)
+    bool iq_input;           ///< Frames hold complex baseband samples as interleaved (I, Q) pairs, f_min may be negative
+    int ring_slots;          ///< If nonzero, the waterfall is a rolling ring buffer spanning this many slots
+    ftx_waterfall_layout_t wf_layout; ///< Memory layout of the waterfall (FTX_WATERFALL_LAYOUT_BLOCKS if left zero)
+    ftx_waterfall_format_t wf_format; ///< Storage format of the waterfall (FTX_WATERFALL_FORMAT_U8 if left zero)
 } monitor_config_t;
 
+/// Function called by the monitor after each block stored in the waterfall, e.g. to update ftx_sync_search_t
+/// @param[in] ctx Context pointer given with the callback
+/// @param[in] wf Waterfall of the monitor, wf->block_count - 1 is the absolute index of the new block
+typedef void (*monitor_block_callback_t)(void* ctx, const ftx_waterfall_t* wf);
+
 /// FT4/FT8 monitor object that manages DSP processing of incoming audio data
 /// and prepares a waterfall object
 typedef struct
@@ -32,25 +53,123 @@ typedef struct
     int nfft;            ///< FFT size
     float fft_norm;      ///< FFT normalization factor
     float* window;       ///< Window function for STFT analysis (nfft samples)
-    float* last_frame;   ///< Current STFT analysis frame (nfft samples)
+    float* last_frame;   ///< Current STFT analysis frame (nfft samples, interleaved I/Q pairs with complex input)
+    kiss_fft_scalar* timedata; ///< Scratch buffer for the windowed analysis frame (nfft samples)
+    kiss_fft_cpx* freqdata;    ///< Scratch buffer for the spectrum of the analysis band
+    kiss_fft_cpx* spectrum;    ///< Scratch buffer for the full spectrum (complex input only)
+#ifndef WATERFALL_USE_PHASE
+    uint8_t* band_mag; ///< Scratch buffer for magnitude codes of the analysis band
+#endif
     ftx_waterfall_t wf;  ///< Waterfall object
     float max_mag;       ///< Maximum detected magnitude (debug stats)
 
+    monitor_engine_t engine; ///< DSP engine in use
+    bool iq_input;           ///< Frames hold complex samples
+    bool ring;               ///< Waterfall is a rolling ring buffer
+
+    monitor_block_callback_t block_callback; ///< Called after each new block if not NULL (set after initialization)
+    void* block_callback_ctx;                ///< Context pointer passed to block_callback
+
+    // Sliding DFT state (MONITOR_ENGINE_SDFT only), last_frame is used as a ring buffer
+    int sdft_begin;       ///< First tracked DFT bin (one guard bin below the band for the Hann window)
+    int sdft_num_bins;    ///< Number of tracked DFT bins
+    int frame_head;       ///< Index of the oldest sample in last_frame
+    double* sdft_state;   ///< Running DFT of the unwindowed analysis frame (sdft_num_bins real parts, then imaginary parts)
+    double* sdft_twiddle; ///< Per-sample rotation exp(j*2*pi*k/nfft) (same layout as sdft_state)
+
     // KISS FFT housekeeping variables
     void* fft_work;        ///< Work area required by Kiss FFT
     kiss_fftr_cfg fft_cfg; ///< Kiss FFT housekeeping object
+    kiss_fft_cfg cfft_cfg; ///< Complex Kiss FFT housekeeping object (complex input only)
 #ifdef WATERFALL_USE_PHASE
     int nifft;             ///< iFFT size
     void* ifft_work;       ///< Work area required by inverse Kiss FFT
     kiss_fft_cfg ifft_cfg; ///< Inverse Kiss FFT housekeeping object
 #endif
+
+    void* mem; ///< Memory block allocated by monitor_init() (NULL when provided by the caller)
 } monitor_t;
 
+/// Initialize the monitor with all of its buffers (including the waterfall) placed in a single memory block.
+/// Follows the convention of kiss_fftr_alloc():
+/// if lenmem is NULL, the block is allocated with malloc() and later released by monitor_free();
+/// otherwise mem is used if *lenmem is large enough, and *lenmem is set to the required size.
+/// Call with mem = NULL to query the size. The block is used from its first MONITOR_MEM_ALIGN boundary.
+/// monitor_process() uses no other memory besides a small, fixed amount of stack.
+/// @param[out] me Monitor object
+/// @param[in] cfg Monitor configuration
+/// @param[in] mem Memory block provided by the caller (or NULL)
+/// @param[in,out] lenmem Size of the memory block (or NULL to allocate it on the heap)
+/// @return True if the monitor was initialized, false if the memory block is missing or too small
+bool monitor_init_mem(monitor_t* me, const monitor_config_t* cfg, void* mem, size_t* lenmem);
+
 void monitor_init(monitor_t* me, const monitor_config_t* cfg);
 void monitor_reset(monitor_t* me);
+
+/// Compute waterfall magnitudes for one frame (block_size samples) of the signal.
+/// The frame is stored as waterfall block wf.block_count, i.e. block n covers the time from n to n + 1
+/// symbol periods since monitor_reset(). A single-slot waterfall stops accepting frames once full.
+/// A rolling waterfall (ring_slots) overwrites the oldest block instead, and never needs monitor_reset() between
+/// slots: select the slot to decode with ftx_waterfall_set_view(). The view always extends to the newest block
+/// and is moved forward when its first blocks get overwritten.
+/// With complex input (iq_input), the frame holds block_size interleaved (I, Q) pairs, and the waterfall bins
+/// cover f_min..f_max of the baseband spectrum, negative frequencies included.
 void monitor_process(monitor_t* me, const float* frame);
 void monitor_free(monitor_t* me);
 
+/// Monitor for several audio streams with the same configuration (e.g. receiver slices).
+/// All channels share one window table, FFT plan and scratch buffers, and each channel writes its own waterfall
+/// (channels[ch].wf). With the FFT engine on SSE capable targets, groups of four channels are transformed
+/// together by the 4-lane kiss_fftr4; the waterfalls are identical to those of separate monitors.
+typedef struct
+{
+    int num_channels;         ///< Number of audio streams
+    int block_size;           ///< Number of samples per channel in one frame
+    monitor_t* channels;      ///< Per-channel monitors (num_channels entries)
+    float* frames;            ///< Scratch buffer for deinterleaved input (num_channels x block_size samples)
+    const float** frame_ptrs; ///< Pointers to the per-channel frames within the scratch buffer
+#ifdef KISS_FFTR4_SUPPORTED
+    float* timedata4;        ///< Windowed analysis frames of four channels, interleaved by sample
+    float* freqdata4;        ///< Band spectra of four channels (see kiss_fftr4_band)
+    kiss_fftr4_cfg fft4_cfg; ///< 4-lane FFT plan (NULL when not used)
+#endif
+    void* mem; ///< Memory block allocated by monitor_multi_init() (NULL when provided by the caller)
+} monitor_multi_t;
+
+/// Initialize a multi-channel monitor with all of its buffers placed in a single memory block.
+/// Same memory conventions as monitor_init_mem().
+/// @param[out] me Multi-channel monitor object
+/// @param[in] cfg Monitor configuration, common to all channels
+/// @param[in] num_channels Number of audio streams
+/// @param[in] mem Memory block provided by the caller (or NULL)
+/// @param[in,out] lenmem Size of the memory block (or NULL to allocate it on the heap)
+/// @return True if the monitor was initialized, false if the memory block is missing or too small
+bool monitor_multi_init_mem(monitor_multi_t* me, const monitor_config_t* cfg, int num_channels, void* mem, size_t* lenmem);
+
+void monitor_multi_init(monitor_multi_t* me, const monitor_config_t* cfg, int num_channels);
+void monitor_multi_reset(monitor_multi_t* me);
+void monitor_multi_free(monitor_multi_t* me);
+
+/// Process one frame (block_size samples, real or complex as configured) of every channel
+/// @param[in] frames Per-channel sample pointers (num_channels entries)
+void monitor_multi_process(monitor_multi_t* me, const float* const frames[]);
+
+/// Process one frame of every channel from interleaved input
+/// @param[in] frame Interleaved samples, sample n of channel ch is frame[n * num_channels + ch]
+/// (with complex input each sample is an (I, Q) pair)
+void monitor_multi_process_interleaved(monitor_multi_t* me, const float* frame);
+
+#ifndef WATERFALL_USE_PHASE
+/// Convert complex spectrum bins to waterfall magnitude codes (0.5 dB steps, 0 = -120 dB, clamped to 0..255).
+/// Uses SSE2/AVX2/NEON when available. The output is identical to the scalar conversion
+/// 2 * 10 * log10(1e-12 + |X|^2) + 240 for every input.
+/// @param[in] freqdata Complex spectrum bins
+/// @param[in] num_bins Number of bins to convert
+/// @param[out] mag Magnitude codes (num_bins entries)
+/// @return Largest power 1e-12 + |X|^2 among the converted bins
+float monitor_quantize_mag(const kiss_fft_cpx* freqdata, int num_bins, uint8_t* mag);
+#endif
+
 #ifdef WATERFALL_USE_PHASE
 void monitor_resynth(const monitor_t* me, const candidate_t* candidate, float* signal);
 #endif
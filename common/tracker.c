@@ -0,0 +1,138 @@
+#include "tracker.h"
+
+#include <stdlib.h>
+#include <math.h>
+
+bool tracker_init_mem(tracker_t* me, int max_entries, int max_age, void* mem, size_t* lenmem)
+{
+    size_t mem_size = max_entries * sizeof(tracker_entry_t);
+    me->mem = NULL;
+    me->max_entries = 0;
+    me->num_entries = 0;
+    me->entries = NULL;
+    if (lenmem == NULL)
+    {
+        mem = me->mem = malloc(mem_size);
+    }
+    else
+    {
+        bool fits = (*lenmem >= mem_size);
+        *lenmem = mem_size;
+        if (!fits)
+            mem = NULL;
+    }
+    if (mem == NULL)
+        return false;
+
+    me->max_entries = max_entries;
+    me->max_age = max_age;
+    me->num_entries = 0;
+    me->entries = (tracker_entry_t*)mem;
+    return true;
+}
+
+bool tracker_init(tracker_t* me, int max_entries, int max_age)
+{
+    return tracker_init_mem(me, max_entries, max_age, NULL, NULL);
+}
+
+void tracker_free(tracker_t* me)
+{
+    // Only the block allocated by tracker_init() is owned by the tracker
+    free(me->mem);
+    me->mem = NULL;
+}
+
+// Number of slots of the same parity from an entry to a slot, or -1 if the parity differs or the entry is newer
+static int tracker_age(const tracker_entry_t* entry, int slot)
+{
+    int distance = slot - entry->slot;
+    if ((distance < 0) || ((distance % 2) != 0))
+        return -1;
+    return distance / 2;
+}
+
+void tracker_add(tracker_t* me, int slot, ftx_protocol_t protocol, float freq, float time)
+{
+    tracker_entry_t* entry = NULL;
+    for (int idx = 0; idx < me->num_entries; ++idx)
+    {
+        tracker_entry_t* other = &me->entries[idx];
+        if ((other->protocol == protocol) && (tracker_age(other, slot) >= 0) && (fabsf(other->freq - freq) <= TRACKER_FREQ_TOLERANCE))
+        {
+            entry = other;
+            break;
+        }
+    }
+    if (entry == NULL)
+    {
+        if (me->num_entries < me->max_entries)
+        {
+            entry = &me->entries[me->num_entries++];
+        }
+        else
+        {
+            // Replace the entry decoded the longest time ago
+            entry = &me->entries[0];
+            for (int idx = 1; idx < me->num_entries; ++idx)
+            {
+                if (me->entries[idx].slot < entry->slot)
+                    entry = &me->entries[idx];
+            }
+        }
+    }
+    entry->freq = freq;
+    entry->time = time;
+    entry->protocol = protocol;
+    entry->slot = slot;
+}
+
+void tracker_shift(tracker_t* me, float delay)
+{
+    for (int idx = 0; idx < me->num_entries; ++idx)
+    {
+        me->entries[idx].time -= delay;
+    }
+}
+
+int tracker_candidates(const tracker_t* me, const monitor_t* mon, int slot, int min_score, ftx_candidate_t candidates[], int max_candidates)
+{
+    const ftx_waterfall_t* wf = &mon->wf;
+    int num_candidates = 0;
+    for (int age = 1; age <= me->max_age; ++age)
+    {
+        for (int idx = 0; (idx < me->num_entries) && (num_candidates < max_candidates); ++idx)
+        {
+            const tracker_entry_t* entry = &me->entries[idx];
+            if ((entry->protocol != wf->protocol) || (tracker_age(entry, slot) != age))
+                continue;
+
+            // Best position around the previous one: the frequency and time of the candidate (see ftx_candidate_t)
+            // are (min_bin + freq_offset + freq_sub / freq_osr) / symbol_period and (time_offset + time_sub / time_osr) * symbol_period
+            int freq_offset = (int)floorf(entry->freq * mon->symbol_period) - mon->min_bin;
+            int time_offset = (int)floorf(entry->time / mon->symbol_period);
+            ftx_search_window_t window = {
+                .freq_offset_min = freq_offset - TRACKER_WINDOW_BINS,
+                .freq_offset_max = freq_offset + TRACKER_WINDOW_BINS,
+                .time_offset_min = time_offset - TRACKER_WINDOW_BLOCKS,
+                .time_offset_max = time_offset + TRACKER_WINDOW_BLOCKS
+            };
+            ftx_candidate_t candidate;
+            if (ftx_find_candidates_windows(wf, &window, 1, 1, &candidate, min_score) == 0)
+                continue;
+
+            // Entries of nearby stations may share their best position
+            bool is_new = true;
+            for (int idx_other = 0; idx_other < num_candidates; ++idx_other)
+            {
+                const ftx_candidate_t* other = &candidates[idx_other];
+                if ((other->time_offset == candidate.time_offset) && (other->freq_offset == candidate.freq_offset) &&
+                    (other->time_sub == candidate.time_sub) && (other->freq_sub == candidate.freq_sub))
+                    is_new = false;
+            }
+            if (is_new)
+                candidates[num_candidates++] = candidate;
+        }
+    }
+    return num_candidates;
+}
@@ -0,0 +1,89 @@
+#ifndef _INCLUDE_TRACKER_H_
+#define _INCLUDE_TRACKER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <common/monitor.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/// Decodes closer than this in frequency (Hz) in slots of the same parity are the same station
+#define TRACKER_FREQ_TOLERANCE 3.0f
+/// Half width of the window searched around a tracked position, in frequency bins
+#define TRACKER_WINDOW_BINS 1
+/// Half width of the window searched around a tracked position, in blocks (symbol periods)
+#define TRACKER_WINDOW_BLOCKS 2
+
+/// Position of a message decoded in an earlier slot
+typedef struct
+{
+    float freq;              ///< Frequency of the lowest tone in Hertz
+    float time;              ///< Time offset from the start of the waterfall view in seconds
+    ftx_protocol_t protocol; ///< Protocol of the message
+    int slot;                ///< Index of the slot of the last decode
+} tracker_entry_t;
+
+/// Stations keep their audio frequency (and roughly their time offset) over the transmissions of a QSO,
+/// every other slot. The tracker records the positions of the messages decoded in earlier slots, and
+/// offers them as priority candidates for the next slots of the same parity, so that they are decoded
+/// first, whatever their rank in the full candidate search.
+typedef struct
+{
+    int max_entries;          ///< Number of entries allocated, the oldest entry is replaced when full
+    int max_age;              ///< Entries expire after this many slots of the same parity without a decode
+    int num_entries;          ///< Number of entries in use
+    tracker_entry_t* entries; ///< Entries (max_entries allocated)
+    void* mem;                ///< Memory block allocated by tracker_init() (NULL when provided by the caller)
+} tracker_t;
+
+/// Initialize an empty tracker with its entries in a memory block, with the same convention as monitor_init_mem():
+/// if lenmem is NULL, the block is allocated with malloc() and later released by tracker_free();
+/// otherwise mem is used if *lenmem is large enough, and *lenmem is set to the required size.
+/// @param[out] me Tracker object
+/// @param[in] max_entries Number of positions tracked
+/// @param[in] max_age Number of slots of the same parity an entry is kept without a new decode
+/// @param[in] mem Memory block provided by the caller (or NULL)
+/// @param[in,out] lenmem Size of the memory block (or NULL to allocate it on the heap)
+/// @return True if the tracker was initialized, false if the memory block is missing or too small (the tracker is then
+/// left without entries)
+bool tracker_init_mem(tracker_t* me, int max_entries, int max_age, void* mem, size_t* lenmem);
+
+/// Initialize an empty tracker with its entries allocated with malloc()
+/// @return True if the tracker was initialized, false if the allocation failed
+bool tracker_init(tracker_t* me, int max_entries, int max_age);
+void tracker_free(tracker_t* me);
+
+/// Record the position of a decoded message, updating the entry of the same station if there is one
+/// @param[in,out] me Tracker object
+/// @param[in] slot Index of the slot of the decode (consecutive slots have consecutive indices)
+/// @param[in] protocol Protocol of the message
+/// @param[in] freq Frequency of the lowest tone in Hertz
+/// @param[in] time Time offset from the start of the waterfall view in seconds
+void tracker_add(tracker_t* me, int slot, ftx_protocol_t protocol, float freq, float time);
+
+/// Move the entries with the slot alignment: the next waterfalls start delay seconds later (earlier if negative),
+/// so the time offsets of the tracked stations from the start of the waterfall view decrease by delay
+/// @param[in,out] me Tracker object
+/// @param[in] delay Delay of the start of the next waterfalls in seconds
+void tracker_shift(tracker_t* me, float delay);
+
+/// Priority candidates of a slot: the best position within a small window (TRACKER_WINDOW_BINS, TRACKER_WINDOW_BLOCKS)
+/// around every entry of the same parity and protocol, most recent entries first
+/// @param[in] me Tracker object
+/// @param[in] mon Monitor with the waterfall of the slot
+/// @param[in] slot Index of the slot
+/// @param[in] min_score Minimal sync score of a candidate
+/// @param[out] candidates Candidates (max_candidates allocated)
+/// @param[in] max_candidates Largest number of candidates
+/// @return Number of candidates
+int tracker_candidates(const tracker_t* me, const monitor_t* mon, int slot, int min_score, ftx_candidate_t candidates[], int max_candidates);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _INCLUDE_TRACKER_H_
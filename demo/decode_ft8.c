@@ -13,6 +13,8 @@
 #include <common/common.h>
 #include <common/wave.h>
 #include <common/monitor.h>
+#include <common/tracker.h>
+#include <common/dt_estimator.h>
 #include <common/audio.h>
 
 #define LOG_LEVEL LOG_INFO
@@ -24,6 +26,28 @@ const int kLDPC_iterations = 25;
 
 const int kMax_decoded_messages = 50;
 
+const int kNum_coarse = 2 * 140; // Coarse positions refined by the coarse-to-fine search (-coarse)
+const int kCoarse_margin = 5;     // Lower coarse score threshold (relative to kMin_score)
+
+const int kNMS_time_radius = 1; // Candidates suppressed by a better one within this many time subdivisions (-nms)
+const int kNMS_freq_radius = 1; // ... and this many frequency subdivisions
+
+const int kDecode_batch = 16; // Candidates decoded at once by ftx_decode_candidates_batch() (-batch)
+
+const int kMax_freqs = 8;             // Frequencies of interest (-freq), searched and decoded first
+const float kFreq_window_hz = 10;     // Half width of the window searched around a frequency of interest
+const int kMax_freq_candidates = 20;  // Candidates decoded around the frequencies of interest
+
+const int kMax_tracked = 50;   // Stations tracked over the slots (live input), decoded first at their previous position
+const int kTracked_max_age = 2; // Slots of the same parity a station stays tracked without a decode
+
+const float kDT_decay = 0.75f;      // Weight of the past slots in the distribution of the time offsets of decodes
+const float kDT_coverage = 0.98f;   // Fraction of the recent decodes within the adaptive DT window
+const int kDT_margin = 3;           // Blocks added on both sides of the adaptive DT window
+const float kDT_min_weight = 10;    // Decodes needed to narrow the DT window
+const float kDT_drop_ratio = 0.5f;  // Widen the DT window for a slot when decodes drop below this fraction of the average
+const float kDT_target = 0.8f;      // Time offset the live slot alignment is re-centered on (middle of the searched offsets)
+
 const int kFreq_osr = 2; // Frequency oversampling rate (bin subdivision)
 const int kTime_osr = 2; // Time oversampling rate (symbol subdivision)
 
@@ -33,8 +57,14 @@ void usage(const char* error_msg)
     {
         fprintf(stderr, "ERROR: %s\n", error_msg);
     }
-    fprintf(stderr, "Usage: decode_ft8 [-list|([-ft4] [INPUT|-dev DEVICE])]\n\n");
+    fprintf(stderr, "Usage: decode_ft8 [-list|([-ft4] [-sdft] [-compact] [-coarse] [-nms] [-batch] [-freq HZ]... [INPUT|-dev DEVICE])]\n\n");
     fprintf(stderr, "Decode a 15-second (or slighly shorter) WAV file.\n");
+    fprintf(stderr, "Use -sdft to compute the waterfall with the sliding DFT engine instead of FFT.\n");
+    fprintf(stderr, "Use -compact to store the waterfall with 4 bits per bin.\n");
+    fprintf(stderr, "Use -coarse to search candidates coarse-to-fine at the end of the slot.\n");
+    fprintf(stderr, "Use -nms to drop candidates next to a better one before decoding.\n");
+    fprintf(stderr, "Use -batch to run the min-sum LDPC decoder on %d candidates at once.\n", kDecode_batch);
+    fprintf(stderr, "Use -freq (up to %d times) to decode around a frequency of interest first.\n", kMax_freqs);
 }
 
 #define CALLSIGN_HASHTABLE_SIZE 256
@@ -127,12 +157,99 @@ ftx_callsign_hash_interface_t hash_if = {
     .save_hash = hashtable_add
 };
 
-void decode(const monitor_t* mon, struct tm* tm_slot_start)
+#ifndef WATERFALL_USE_PHASE
+// Block callback of the monitor: update the candidate search while the slot is being captured
+static void update_search(void* ctx, const ftx_waterfall_t* wf)
+{
+    ftx_sync_search_update((ftx_sync_search_t*)ctx, wf);
+}
+#endif
+
+// Append the candidates not tried yet, i.e. at a position different from those of list[0] .. list[num_list - 1]
+// @return New number of candidates in the list
+static int append_untried(ftx_candidate_t list[], int num_list, const ftx_candidate_t candidates[], int num_candidates)
+{
+    const int num_tried = num_list;
+    for (int idx = 0; idx < num_candidates; ++idx)
+    {
+        const ftx_candidate_t* cand = &candidates[idx];
+        bool tried = false;
+        for (int idx_tried = 0; idx_tried < num_tried; ++idx_tried)
+        {
+            const ftx_candidate_t* other = &list[idx_tried];
+            if ((cand->time_offset == other->time_offset) && (cand->freq_offset == other->freq_offset) &&
+                (cand->time_sub == other->time_sub) && (cand->freq_sub == other->freq_sub))
+            {
+                tried = true;
+                break;
+            }
+        }
+        if (!tried)
+        {
+            list[num_list++] = *cand;
+        }
+    }
+    return num_list;
+}
+
+void decode(const monitor_t* mon, struct tm* tm_slot_start, ftx_sync_search_t* search, const ftx_search_params_t* coarse_params, void* coarse_mem, bool nms, bool batch,
+    const float freqs[], int num_freqs, tracker_t* tracker, int slot, dt_estimator_t* dt)
 {
     const ftx_waterfall_t* wf = &mon->wf;
-    // Find top candidates by Costas sync score and localize them in time and frequency
-    ftx_candidate_t candidate_list[kMax_candidates];
-    int num_candidates = ftx_find_candidates(wf, kMax_candidates, candidate_list, kMin_score);
+    ftx_candidate_t candidate_list[kMax_tracked + kMax_freq_candidates + kMax_candidates];
+    ftx_candidate_t found[kMax_candidates];
+    int num_found;
+
+    // Stations decoded in the previous slots of the same parity, then the candidates around the frequencies
+    // of interest are decoded (and printed) first
+    num_found = tracker_candidates(tracker, mon, slot, kMin_score, found, kMax_tracked);
+    int num_priority = append_untried(candidate_list, 0, found, num_found);
+    if (num_freqs > 0)
+    {
+        ftx_search_window_t windows[kMax_freqs];
+        for (int i = 0; i < num_freqs; ++i)
+        {
+            windows[i].freq_offset_min = (int)floorf((freqs[i] - kFreq_window_hz) * mon->symbol_period) - mon->min_bin;
+            windows[i].freq_offset_max = (int)ceilf((freqs[i] + kFreq_window_hz) * mon->symbol_period) - mon->min_bin;
+            windows[i].time_offset_min = -10;
+            windows[i].time_offset_max = 19;
+        }
+        num_found = ftx_find_candidates_windows(wf, windows, num_freqs, kMax_freq_candidates, found, kMin_score);
+        num_priority = append_untried(candidate_list, num_priority, found, num_found);
+    }
+
+    // Find top candidates by Costas sync score and localize them in time and frequency,
+    // within the DT window where the messages of the recent slots were decoded
+    if (coarse_params != NULL)
+    {
+        ftx_search_params_t params = *coarse_params;
+        params.time_offset_min = (dt->time_offset_min > params.time_offset_min) ? dt->time_offset_min : params.time_offset_min;
+        params.time_offset_max = (dt->time_offset_max < params.time_offset_max) ? dt->time_offset_max : params.time_offset_max;
+        num_found = ftx_find_candidates_coarse(wf, &params, coarse_mem, kMax_candidates, found, kMin_score);
+    }
+    else
+    {
+#ifdef WATERFALL_USE_PHASE
+        const bool narrowed = (dt->time_offset_max - dt->time_offset_min + 1 < DT_ESTIMATOR_NUM_OFFSETS);
+        ftx_search_window_t window = { .freq_offset_min = 0, .freq_offset_max = wf->num_bins, .time_offset_min = dt->time_offset_min, .time_offset_max = dt->time_offset_max };
+        if (narrowed)
+            num_found = ftx_find_candidates_windows(wf, &window, 1, kMax_candidates, found, kMin_score);
+        else
+            num_found = ftx_find_candidates(wf, kMax_candidates, found, kMin_score);
+#else
+        // The sums of the incremental search are ranked within the DT window only
+        num_found = ftx_sync_search_candidates(search, wf, dt->time_offset_min, dt->time_offset_max, kMax_candidates, found, kMin_score);
+#endif
+    }
+
+    // Keep only local maxima: the neighbors of a strong signal would decode to the same message
+    if (nms)
+    {
+        num_found = ftx_prune_candidates(wf, num_found, found, kNMS_time_radius, kNMS_freq_radius);
+    }
+
+    // Skip the positions already tried first
+    int num_candidates = append_untried(candidate_list, num_priority, found, num_found);
 
     // Hash table for decoded messages (to check for duplicates)
     int num_decoded = 0;
@@ -146,9 +263,32 @@ void decode(const monitor_t* mon, struct tm* tm_slot_start)
     }
 
     // Go over candidates and attempt to decode messages
+    ftx_message_t batch_messages[kDecode_batch];
+    ftx_decode_status_t batch_status[kDecode_batch];
+    bool batch_decoded[kDecode_batch];
+    int batch_start = 0;
+    int batch_end = 0;
     for (int idx = 0; idx < num_candidates; ++idx)
     {
         const ftx_candidate_t* cand = &candidate_list[idx];
+        if ((idx == num_priority) && (num_priority > 0))
+        {
+            // Messages of the tracked stations and around the frequencies of interest are out, before the full search is decoded
+            fflush(stdout);
+        }
+
+        if (batch && (idx == batch_end))
+        {
+            // Decode the next candidates together, without mixing the priority candidates with the others
+            batch_start = idx;
+            batch_end = idx + kDecode_batch;
+            int limit = (idx < num_priority) ? num_priority : num_candidates;
+            if (batch_end > limit)
+            {
+                batch_end = limit;
+            }
+            ftx_decode_candidates_batch(wf, cand, batch_end - batch_start, kLDPC_iterations, batch_messages, batch_status, batch_decoded);
+        }
 
         float freq_hz = (mon->min_bin + cand->freq_offset + (float)cand->freq_sub / wf->freq_osr) / mon->symbol_period;
         float time_sec = (cand->time_offset + (float)cand->time_sub / wf->time_osr) * mon->symbol_period;
@@ -168,7 +308,18 @@ void decode(const monitor_t* mon, struct tm* tm_slot_start)
 
         ftx_message_t message;
         ftx_decode_status_t status;
-        if (!ftx_decode_candidate(wf, cand, kLDPC_iterations, &message, &status))
+        bool ok;
+        if (batch)
+        {
+            message = batch_messages[idx - batch_start];
+            status = batch_status[idx - batch_start];
+            ok = batch_decoded[idx - batch_start];
+        }
+        else
+        {
+            ok = ftx_decode_candidate(wf, cand, kLDPC_iterations, &message, &status);
+        }
+        if (!ok)
         {
             if (status.ldpc_errors > 0)
             {
@@ -211,6 +362,8 @@ void decode(const monitor_t* mon, struct tm* tm_slot_start)
             memcpy(&decoded[idx_hash], &message, sizeof(message));
             decoded_hashtable[idx_hash] = &decoded[idx_hash];
             ++num_decoded;
+            tracker_add(tracker, slot, wf->protocol, freq_hz, time_sec);
+            dt_estimator_add(dt, time_sec);
 
             char text[FTX_MAX_MESSAGE_LENGTH];
             ftx_message_offsets_t offsets;
@@ -237,7 +390,14 @@ int main(int argc, char** argv)
     const char* wav_path = NULL;
     const char* dev_name = NULL;
     ftx_protocol_t protocol = FTX_PROTOCOL_FT8;
+    monitor_engine_t engine = MONITOR_ENGINE_FFT;
+    ftx_waterfall_format_t wf_format = FTX_WATERFALL_FORMAT_U8;
     float time_shift = 0.8;
+    bool coarse = false;
+    bool nms = false;
+    bool batch = false;
+    float freqs[kMax_freqs];
+    int num_freqs = 0;
 
     // Parse arguments one by one
     int arg_idx = 1;
@@ -251,6 +411,39 @@ int main(int argc, char** argv)
             {
                 protocol = FTX_PROTOCOL_FT4;
             }
+            else if (0 == strcmp(argv[arg_idx], "-sdft"))
+            {
+                engine = MONITOR_ENGINE_SDFT;
+            }
+            else if (0 == strcmp(argv[arg_idx], "-compact"))
+            {
+                wf_format = FTX_WATERFALL_FORMAT_U4;
+            }
+            else if (0 == strcmp(argv[arg_idx], "-coarse"))
+            {
+                coarse = true;
+            }
+            else if (0 == strcmp(argv[arg_idx], "-nms"))
+            {
+                nms = true;
+            }
+            else if (0 == strcmp(argv[arg_idx], "-batch"))
+            {
+                batch = true;
+            }
+            else if (0 == strcmp(argv[arg_idx], "-freq"))
+            {
+                if ((arg_idx + 1 < argc) && (num_freqs < kMax_freqs))
+                {
+                    ++arg_idx;
+                    freqs[num_freqs++] = atof(argv[arg_idx]);
+                }
+                else
+                {
+                    usage("Expected a frequency in Hz after -freq (at most 8 of them)");
+                    return -1;
+                }
+            }
             else if (0 == strcmp(argv[arg_idx], "-list"))
             {
                 audio_init();
@@ -329,7 +522,9 @@ int main(int argc, char** argv)
         .sample_rate = sample_rate,
         .time_osr = kTime_osr,
         .freq_osr = kFreq_osr,
-        .protocol = protocol
+        .protocol = protocol,
+        .engine = engine,
+        .wf_format = wf_format
     };
 
     hashtable_init();
@@ -337,9 +532,66 @@ int main(int argc, char** argv)
     monitor_init(&mon, &mon_cfg);
     LOG(LOG_DEBUG, "Waterfall allocated %d symbols\n", mon.wf.max_blocks);
 
+    // Coarse-to-fine search over the time offsets searched by ftx_find_candidates()
+    const ftx_search_params_t coarse_params = { .time_offset_min = -10, .time_offset_max = 19, .num_coarse = kNum_coarse, .coarse_margin = kCoarse_margin };
+
+    // Incremental candidate search, updated by the monitor as blocks arrive
+    ftx_sync_search_t search;
+    void* search_mem = NULL;
+#ifndef WATERFALL_USE_PHASE
+    search_mem = malloc(ftx_sync_search_size(&mon.wf));
+    if (search_mem == NULL)
+    {
+        LOG(LOG_ERROR, "ERROR: cannot allocate the candidate search state\n");
+        monitor_free(&mon);
+        return -1;
+    }
+    ftx_sync_search_init(&search, &mon.wf, search_mem);
+    mon.block_callback = update_search;
+    mon.block_callback_ctx = &search;
+#endif
+
+    // Scratch memory of the coarse-to-fine search, sized for the full time offset window
+    void* coarse_mem = NULL;
+    if (coarse)
+    {
+        coarse_mem = malloc(ftx_find_candidates_coarse_size(&mon.wf, &coarse_params));
+        if (coarse_mem == NULL)
+        {
+            LOG(LOG_ERROR, "ERROR: cannot allocate the coarse search memory\n");
+            free(search_mem);
+            monitor_free(&mon);
+            return -1;
+        }
+    }
+
+    // Positions of the stations decoded in the previous slots
+    tracker_t tracker;
+    if (!tracker_init(&tracker, kMax_tracked, kTracked_max_age))
+    {
+        LOG(LOG_ERROR, "ERROR: cannot allocate the station tracker\n");
+        free(coarse_mem);
+        free(search_mem);
+        monitor_free(&mon);
+        return -1;
+    }
+
+    // Distribution of the time offsets of the decodes, narrowing the DT window and re-centering the slot alignment
+    dt_estimator_t dt;
+    const dt_estimator_config_t dt_cfg = {
+        .symbol_period = mon.symbol_period,
+        .decay = kDT_decay,
+        .coverage = kDT_coverage,
+        .margin = kDT_margin,
+        .min_weight = kDT_min_weight,
+        .drop_ratio = kDT_drop_ratio
+    };
+    dt_estimator_init(&dt, &dt_cfg);
+
     do
     {
         struct tm tm_slot_start = { 0 };
+        int slot = 0;
         if (is_live)
         {
             // Wait for the start of time slot
@@ -356,6 +608,7 @@ int main(int argc, char** argv)
                 else
                 {
                     time_t time_slot_start = (time_t)(time - time_within_slot);
+                    slot = (int)floor((time - time_shift) / slot_period);
                     gmtime_r(&time_slot_start, &tm_slot_start);
                     LOG(LOG_INFO, "Time within slot %02d%02d%02d: %.3f s\n", tm_slot_start.tm_hour,
                         tm_slot_start.tm_min, tm_slot_start.tm_sec, time_within_slot);
@@ -364,6 +617,10 @@ int main(int argc, char** argv)
             }
         }
 
+#ifndef WATERFALL_USE_PHASE
+        ftx_sync_search_start(&search, 0, mon.wf.max_blocks);
+#endif
+
         // Process and accumulate audio data in a monitor/waterfall instance
         for (int frame_pos = 0; frame_pos + mon.block_size <= num_samples; frame_pos += mon.block_size)
         {
@@ -381,12 +638,28 @@ int main(int argc, char** argv)
         LOG(LOG_INFO, "Max magnitude: %.1f dB\n", mon.max_mag);
 
         // Decode accumulated data (containing slightly less than a full time slot)
-        decode(&mon, &tm_slot_start);
+        decode(&mon, &tm_slot_start, &search, coarse ? &coarse_params : NULL, coarse_mem, nms, batch, freqs, num_freqs, &tracker, slot, &dt);
+
+        dt_estimator_end_slot(&dt);
+        if (is_live)
+        {
+            // Move the start of the next waterfalls by whole symbol periods, towards the time offsets of the decodes,
+            // and the tracked stations with them
+            float delay = dt_estimator_recenter(&dt, kDT_target) * mon.symbol_period;
+            time_shift += delay;
+            tracker_shift(&tracker, delay);
+        }
+        LOG(LOG_INFO, "DT window %+.2f .. %+.2f s (median %+.2f s, %.1f decodes per slot%s), time shift %.2f s\n",
+            dt.time_offset_min * mon.symbol_period, (dt.time_offset_max + 1) * mon.symbol_period, dt.center, dt.mean_decodes,
+            dt.widened ? ", widened" : "", time_shift);
 
         // Reset internal variables for the next time slot
         monitor_reset(&mon);
     } while (is_live);
 
+    tracker_free(&tracker);
+    free(coarse_mem);
+    free(search_mem);
     monitor_free(&mon);
 
     return 0;
@@ -6,6 +6,9 @@
  *  See COPYING file for more information.
  */
 
+#ifndef _kiss_fft_guts_h
+#define _kiss_fft_guts_h
+
 /* kiss_fft.h
    defines kiss_fft_scalar as either short or a float type
    and defines
@@ -156,3 +159,5 @@ struct kiss_fft_state{
 #define  KISS_FFT_TMP_ALLOC(nbytes) KISS_FFT_MALLOC(nbytes)
 #define  KISS_FFT_TMP_FREE(ptr) KISS_FFT_FREE(ptr)
 #endif
+
+#endif /* _kiss_fft_guts_h */
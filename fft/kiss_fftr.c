@@ -114,6 +114,63 @@ void kiss_fftr(kiss_fftr_cfg st,const kiss_fft_scalar *timedata,kiss_fft_cpx *fr
     }
 }
 
+void kiss_fftr_band(kiss_fftr_cfg st,const kiss_fft_scalar *timedata,kiss_fft_cpx *freqdata,int bin_begin,int bin_end)
+{
+    /* input buffer timedata is stored row-wise */
+    int k,nk,ncfft;
+    kiss_fft_cpx fpnk,fpk,f1k,f2k,tw,tdc;
+
+    if ( st->substate->inverse) {
+        fprintf(stderr,"kiss fft usage error: improper alloc\n");
+        exit(1);
+    }
+
+    ncfft = st->substate->nfft;
+
+    /*perform the parallel fft of two real signals packed in real,imag*/
+    kiss_fft( st->substate , (const kiss_fft_cpx*)timedata, st->tmpbuf );
+
+    /* Same split as in kiss_fftr, but each output bin is computed from its own
+     * (k, ncfft-k) pair only when it falls into [bin_begin, bin_end) */
+    for ( k=bin_begin; k < bin_end; ++k ) {
+        kiss_fft_cpx * fout = freqdata + (k - bin_begin);
+        if (k == 0 || k == ncfft) {
+            tdc.r = st->tmpbuf[0].r;
+            tdc.i = st->tmpbuf[0].i;
+            C_FIXDIV(tdc,2);
+            CHECK_OVERFLOW_OP(tdc.r ,+, tdc.i);
+            CHECK_OVERFLOW_OP(tdc.r ,-, tdc.i);
+            fout->r = (k == 0) ? (tdc.r + tdc.i) : (tdc.r - tdc.i);
+#ifdef USE_SIMD
+            fout->i = _mm_set1_ps(0);
+#else
+            fout->i = 0;
+#endif
+            continue;
+        }
+
+        /* kiss_fftr writes bin ncfft/2 twice, the second (mirrored) value wins */
+        nk = (2 * k < ncfft) ? k : (ncfft - k);
+        fpk    = st->tmpbuf[nk];
+        fpnk.r =   st->tmpbuf[ncfft-nk].r;
+        fpnk.i = - st->tmpbuf[ncfft-nk].i;
+        C_FIXDIV(fpk,2);
+        C_FIXDIV(fpnk,2);
+
+        C_ADD( f1k, fpk , fpnk );
+        C_SUB( f2k, fpk , fpnk );
+        C_MUL( tw , f2k , st->super_twiddles[nk-1]);
+
+        if (2 * k < ncfft) {
+            fout->r = HALF_OF(f1k.r + tw.r);
+            fout->i = HALF_OF(f1k.i + tw.i);
+        } else {
+            fout->r = HALF_OF(f1k.r - tw.r);
+            fout->i = HALF_OF(tw.i - f1k.i);
+        }
+    }
+}
+
 void kiss_fftri(kiss_fftr_cfg st,const kiss_fft_cpx *freqdata,kiss_fft_scalar *timedata)
 {
     /* input buffer timedata is stored row-wise */
@@ -40,6 +40,16 @@ void kiss_fftr(kiss_fftr_cfg cfg,const kiss_fft_scalar *timedata,kiss_fft_cpx *f
  output freqdata has nfft/2+1 complex points
 */
 
+void kiss_fftr_band(kiss_fftr_cfg cfg,const kiss_fft_scalar *timedata,kiss_fft_cpx *freqdata,int bin_begin,int bin_end);
+/*
+ input timedata has nfft scalar points
+ output freqdata has (bin_end - bin_begin) complex points, freqdata[0] being bin bin_begin
+ (0 <= bin_begin < bin_end <= nfft/2+1)
+
+ Only the requested bins are computed in the final real-to-complex split stage.
+ The results are bit-exact with the corresponding bins of kiss_fftr.
+*/
+
 void kiss_fftri(kiss_fftr_cfg cfg,const kiss_fft_cpx *freqdata,kiss_fft_scalar *timedata);
 /*
  input freqdata has  nfft/2+1 complex points
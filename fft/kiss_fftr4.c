@@ -0,0 +1,36 @@
+/*
+ * Four-channel real FFT: the KISS FFT sources are compiled once more with
+ * USE_SIMD (kiss_fft_scalar = __m128) under different symbol names, so that
+ * they can be linked together with the float version.
+ */
+
+#include "kiss_fftr4.h"
+
+#ifdef KISS_FFTR4_SUPPORTED
+
+#define USE_SIMD
+#define kiss_fft_alloc          kiss_fft4_alloc
+#define kiss_fft_stride         kiss_fft4_stride
+#define kiss_fft                kiss_fft4
+#define kiss_fft_cleanup        kiss_fft4_cleanup
+#define kiss_fft_next_fast_size kiss_fft4_next_fast_size
+#define kiss_fftr_state         kiss_fftr4_state
+#define kiss_fftr_alloc         kiss_fftr4_simd_alloc
+#define kiss_fftr               kiss_fftr4_simd
+#define kiss_fftr_band          kiss_fftr4_simd_band
+#define kiss_fftri              kiss_fftri4_simd
+
+#include "kiss_fft.c"
+#include "kiss_fftr.c"
+
+kiss_fftr4_cfg kiss_fftr4_alloc(int nfft,void * mem,size_t * lenmem)
+{
+    return kiss_fftr4_simd_alloc(nfft, 0, mem, lenmem);
+}
+
+void kiss_fftr4_band(kiss_fftr4_cfg cfg,const float *timedata,float *freqdata,int bin_begin,int bin_end)
+{
+    kiss_fftr4_simd_band(cfg, (const kiss_fft_scalar *)timedata, (kiss_fft_cpx *)freqdata, bin_begin, bin_end);
+}
+
+#endif
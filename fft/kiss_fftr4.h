@@ -0,0 +1,41 @@
+/*
+ * Four-channel real FFT, built from KISS FFT compiled in USE_SIMD mode (SSE).
+ * Four independent real sequences are transformed at once, one per __m128 lane.
+ * Every lane performs exactly the same arithmetic as the float kiss_fftr, so the
+ * results are bit-exact with four separate kiss_fftr / kiss_fftr_band calls.
+ */
+
+#ifndef KISS_FTR4_H
+#define KISS_FTR4_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__SSE__)
+#define KISS_FFTR4_SUPPORTED 1
+
+typedef struct kiss_fftr4_state *kiss_fftr4_cfg;
+
+kiss_fftr4_cfg kiss_fftr4_alloc(int nfft,void * mem,size_t * lenmem);
+/*
+ Same conventions as kiss_fftr_alloc (forward transform only), nfft must be even.
+ mem must be aligned to 16 bytes.
+*/
+
+void kiss_fftr4_band(kiss_fftr4_cfg cfg,const float *timedata,float *freqdata,int bin_begin,int bin_end);
+/*
+ input timedata has nfft x 4 floats: sample n of channel c is timedata[4*n + c]
+ output freqdata has (bin_end - bin_begin) x 8 floats: for each bin, the real parts
+ of channels 0..3 followed by the imaginary parts of channels 0..3
+ Both buffers must be aligned to 16 bytes.
+*/
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif
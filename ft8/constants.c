@@ -389,4 +389,716 @@ const uint8_t kFTX_LDPC_Num_rows[FTX_LDPC_M] = {
     6, 6, 7, 6, 6, 6, 7, 6, 6, 6, 6, 7, 6, 6, 6, 7,
     6, 6, 6, 7, 7, 6, 6, 7, 6, 6, 6, 6, 6, 6, 6, 7,
     6, 6, 6
-};
\ No newline at end of file
+};
+
+// Generated by utils/gen_ldpc_tables.py
+
+const uint16_t kFTX_LDPC_Check_offset[FTX_LDPC_M + 1] = {
+    0, 7, 13, 19, 25, 32, 38, 45, 51, 57, 64, 70,
+    76, 83, 90, 96, 102, 108, 115, 121, 128, 134, 141, 147,
+    153, 159, 166, 172, 178, 184, 191, 197, 203, 209, 215, 222,
+    228, 234, 240, 247, 254, 260, 266, 272, 278, 285, 292, 298,
+    304, 310, 316, 323, 329, 335, 341, 348, 354, 360, 366, 372,
+    379, 385, 391, 397, 404, 410, 416, 422, 429, 436, 442, 448,
+    455, 461, 467, 473, 479, 485, 491, 497, 504, 510, 516, 522,
+};
+
+const uint8_t kFTX_LDPC_Edge_bit[FTX_LDPC_NUM_EDGES] = {
+    3, 30, 58, 90, 91, 95, 152, 4, 31, 59, 92, 114, 145, 5, 23, 60,
+    93, 121, 150, 6, 32, 61, 94, 95, 142, 7, 24, 62, 82, 92, 95, 147,
+    5, 31, 63, 96, 125, 137, 4, 33, 64, 77, 97, 106, 153, 8, 34, 65,
+    98, 138, 145, 9, 35, 66, 99, 106, 125, 10, 36, 66, 86, 100, 138, 157,
+    11, 37, 67, 101, 104, 154, 12, 38, 68, 102, 148, 161, 7, 39, 69, 81,
+    103, 113, 144, 13, 40, 70, 87, 101, 122, 155, 14, 41, 58, 105, 122, 158,
+    0, 32, 71, 105, 106, 156, 15, 42, 72, 107, 140, 159, 16, 36, 73, 80,
+    108, 130, 153, 10, 43, 74, 109, 120, 165, 44, 54, 63, 110, 129, 160, 172,
+    7, 45, 70, 111, 118, 165, 17, 35, 75, 88, 112, 113, 142, 18, 37, 76,
+    103, 115, 162, 19, 46, 69, 91, 137, 164, 1, 47, 73, 112, 127, 159, 20,
+    44, 77, 82, 116, 120, 150, 21, 46, 57, 117, 126, 163, 15, 38, 61, 111,
+    133, 157, 22, 42, 78, 119, 130, 144, 18, 34, 58, 72, 109, 124, 160, 19,
+    35, 62, 93, 135, 160, 13, 30, 78, 97, 131, 163, 2, 43, 79, 123, 126,
+    168, 18, 45, 80, 116, 134, 166, 6, 48, 57, 89, 99, 104, 167, 11, 49,
+    60, 117, 118, 143, 12, 50, 63, 113, 117, 156, 23, 51, 75, 128, 147, 148,
+    24, 52, 68, 89, 100, 129, 155, 19, 45, 64, 79, 119, 139, 169, 20, 53,
+    76, 99, 139, 170, 34, 81, 132, 141, 170, 173, 13, 29, 82, 112, 124, 169,
+    3, 28, 67, 119, 133, 172, 0, 3, 51, 56, 85, 135, 151, 25, 50, 55,
+    90, 121, 136, 167, 51, 83, 109, 114, 144, 167, 6, 49, 80, 98, 131, 172,
+    22, 54, 66, 94, 171, 173, 25, 40, 76, 108, 140, 147, 1, 26, 40, 60,
+    61, 114, 132, 26, 39, 55, 123, 124, 125, 17, 48, 54, 123, 140, 166, 5,
+    32, 84, 107, 115, 155, 27, 47, 69, 84, 104, 128, 157, 8, 53, 62, 130,
+    146, 154, 21, 52, 67, 108, 120, 173, 2, 12, 47, 77, 94, 122, 30, 68,
+    132, 149, 154, 168, 11, 42, 65, 88, 96, 134, 158, 4, 38, 74, 101, 135,
+    166, 1, 53, 85, 100, 134, 163, 14, 55, 86, 107, 118, 170, 9, 43, 81,
+    90, 110, 143, 148, 22, 33, 70, 93, 126, 152, 10, 48, 87, 91, 141, 156,
+    28, 33, 86, 96, 146, 161, 29, 49, 59, 85, 136, 141, 161, 9, 52, 65,
+    83, 111, 127, 164, 21, 56, 84, 92, 139, 158, 27, 31, 71, 102, 131, 165,
+    27, 28, 83, 87, 116, 142, 149, 0, 25, 44, 79, 127, 146, 16, 26, 88,
+    102, 115, 152, 50, 56, 97, 162, 164, 171, 20, 36, 72, 137, 151, 168, 15,
+    46, 75, 129, 136, 153, 2, 23, 29, 71, 103, 138, 8, 39, 89, 105, 133,
+    150, 14, 57, 59, 73, 110, 149, 162, 17, 41, 78, 143, 145, 151, 24, 37,
+    64, 98, 121, 159, 16, 41, 74, 128, 169, 171,
+};
+
+const uint16_t kFTX_LDPC_Edge_slot[FTX_LDPC_NUM_EDGES] = {
+    9, 90, 174, 270, 273, 285, 456, 12, 93, 177, 276, 342,
+    435, 15, 69, 180, 279, 363, 450, 18, 96, 183, 282, 286,
+    426, 21, 72, 186, 246, 277, 287, 441, 16, 94, 189, 288,
+    375, 411, 13, 99, 192, 231, 291, 318, 459, 24, 102, 195,
+    294, 414, 436, 27, 105, 198, 297, 319, 376, 30, 108, 199,
+    258, 300, 415, 471, 33, 111, 201, 303, 312, 462, 36, 114,
+    204, 306, 444, 483, 22, 117, 207, 243, 309, 339, 432, 39,
+    120, 210, 261, 304, 366, 465, 42, 123, 175, 315, 367, 474,
+    0, 97, 213, 316, 320, 468, 45, 126, 216, 321, 420, 477,
+    48, 109, 219, 240, 324, 390, 460, 31, 129, 222, 327, 360,
+    495, 132, 162, 190, 330, 387, 480, 516, 23, 135, 211, 333,
+    354, 496, 51, 106, 225, 264, 336, 340, 427, 54, 112, 228,
+    310, 345, 486, 57, 138, 208, 274, 412, 492, 3, 141, 220,
+    337, 381, 478, 60, 133, 232, 247, 348, 361, 451, 63, 139,
+    171, 351, 378, 489, 46, 115, 184, 334, 399, 472, 66, 127,
+    234, 357, 391, 433, 55, 103, 176, 217, 328, 372, 481, 58,
+    107, 187, 280, 405, 482, 40, 91, 235, 292, 393, 490, 6,
+    130, 237, 369, 379, 504, 56, 136, 241, 349, 402, 498, 19,
+    144, 172, 267, 298, 313, 501, 34, 147, 181, 352, 355, 429,
+    37, 150, 191, 341, 353, 469, 70, 153, 226, 384, 442, 445,
+    73, 156, 205, 268, 301, 388, 466, 59, 137, 193, 238, 358,
+    417, 507, 61, 159, 229, 299, 418, 510, 104, 244, 396, 423,
+    511, 519, 41, 87, 248, 338, 373, 508, 10, 84, 202, 359,
+    400, 517, 1, 11, 154, 168, 255, 406, 453, 75, 151, 165,
+    271, 364, 408, 502, 155, 249, 329, 343, 434, 503, 20, 148,
+    242, 295, 394, 518, 67, 163, 200, 283, 513, 520, 76, 121,
+    230, 325, 421, 443, 4, 78, 122, 182, 185, 344, 397, 79,
+    118, 166, 370, 374, 377, 52, 145, 164, 371, 422, 499, 17,
+    98, 252, 322, 346, 467, 81, 142, 209, 253, 314, 385, 473,
+    25, 160, 188, 392, 438, 463, 64, 157, 203, 326, 362, 521,
+    7, 38, 143, 233, 284, 368, 92, 206, 398, 447, 464, 505,
+    35, 128, 196, 265, 289, 403, 475, 14, 116, 223, 305, 407,
+    500, 5, 161, 256, 302, 404, 491, 43, 167, 259, 323, 356,
+    512, 28, 131, 245, 272, 331, 430, 446, 68, 100, 212, 281,
+    380, 457, 32, 146, 262, 275, 424, 470, 85, 101, 260, 290,
+    439, 484, 88, 149, 178, 257, 409, 425, 485, 29, 158, 197,
+    250, 335, 382, 493, 65, 169, 254, 278, 419, 476, 82, 95,
+    214, 307, 395, 497, 83, 86, 251, 263, 350, 428, 448, 2,
+    77, 134, 239, 383, 440, 49, 80, 266, 308, 347, 458, 152,
+    170, 293, 487, 494, 514, 62, 110, 218, 413, 454, 506, 47,
+    140, 227, 389, 410, 461, 8, 71, 89, 215, 311, 416, 26,
+    119, 269, 317, 401, 452, 44, 173, 179, 221, 332, 449, 488,
+    53, 124, 236, 431, 437, 455, 74, 113, 194, 296, 365, 479,
+    50, 125, 224, 386, 509, 515,
+};
+
+const uint8_t kFTX_LDPC_Bit_check[FTX_LDPC_N][3] = {
+    { 15, 44, 72 },
+    { 24, 50, 61 },
+    { 32, 57, 77 },
+    { 0, 43, 44 },
+    { 1, 6, 60 },
+    { 2, 5, 53 },
+    { 3, 34, 47 },
+    { 4, 12, 20 },
+    { 7, 55, 78 },
+    { 8, 63, 68 },
+    { 9, 18, 65 },
+    { 10, 35, 59 },
+    { 11, 36, 57 },
+    { 13, 31, 42 },
+    { 14, 62, 79 },
+    { 16, 27, 76 },
+    { 17, 73, 82 },
+    { 21, 52, 80 },
+    { 22, 29, 33 },
+    { 23, 30, 39 },
+    { 25, 40, 75 },
+    { 26, 56, 69 },
+    { 28, 48, 64 },
+    { 2, 37, 77 },
+    { 4, 38, 81 },
+    { 45, 49, 72 },
+    { 50, 51, 73 },
+    { 54, 70, 71 },
+    { 43, 66, 71 },
+    { 42, 67, 77 },
+    { 0, 31, 58 },
+    { 1, 5, 70 },
+    { 3, 15, 53 },
+    { 6, 64, 66 },
+    { 7, 29, 41 },
+    { 8, 21, 30 },
+    { 9, 17, 75 },
+    { 10, 22, 81 },
+    { 11, 27, 60 },
+    { 12, 51, 78 },
+    { 13, 49, 50 },
+    { 14, 80, 82 },
+    { 16, 28, 59 },
+    { 18, 32, 63 },
+    { 19, 25, 72 },
+    { 20, 33, 39 },
+    { 23, 26, 76 },
+    { 24, 54, 57 },
+    { 34, 52, 65 },
+    { 35, 47, 67 },
+    { 36, 45, 74 },
+    { 37, 44, 46 },
+    { 38, 56, 68 },
+    { 40, 55, 61 },
+    { 19, 48, 52 },
+    { 45, 51, 62 },
+    { 44, 69, 74 },
+    { 26, 34, 79 },
+    { 0, 14, 29 },
+    { 1, 67, 79 },
+    { 2, 35, 50 },
+    { 3, 27, 50 },
+    { 4, 30, 55 },
+    { 5, 19, 36 },
+    { 6, 39, 81 },
+    { 7, 59, 68 },
+    { 8, 9, 48 },
+    { 10, 43, 56 },
+    { 11, 38, 58 },
+    { 12, 23, 54 },
+    { 13, 20, 64 },
+    { 15, 70, 77 },
+    { 16, 29, 75 },
+    { 17, 24, 79 },
+    { 18, 60, 82 },
+    { 21, 37, 76 },
+    { 22, 40, 49 },
+    { 6, 25, 57 },
+    { 28, 31, 80 },
+    { 32, 39, 72 },
+    { 17, 33, 47 },
+    { 12, 41, 63 },
+    { 4, 25, 42 },
+    { 46, 68, 71 },
+    { 53, 54, 69 },
+    { 44, 61, 67 },
+    { 9, 62, 66 },
+    { 13, 65, 71 },
+    { 21, 59, 73 },
+    { 34, 38, 78 },
+    { 0, 45, 63 },
+    { 0, 23, 65 },
+    { 1, 4, 69 },
+    { 2, 30, 64 },
+    { 3, 48, 57 },
+    { 0, 3, 4 },
+    { 5, 59, 66 },
+    { 6, 31, 74 },
+    { 7, 47, 81 },
+    { 8, 34, 40 },
+    { 9, 38, 61 },
+    { 10, 13, 60 },
+    { 11, 70, 73 },
+    { 12, 22, 77 },
+    { 10, 34, 54 },
+    { 14, 15, 78 },
+    { 6, 8, 15 },
+    { 16, 53, 62 },
+    { 17, 49, 56 },
+    { 18, 29, 46 },
+    { 19, 63, 79 },
+    { 20, 27, 68 },
+    { 21, 24, 42 },
+    { 12, 21, 36 },
+    { 1, 46, 50 },
+    { 22, 53, 73 },
+    { 25, 33, 71 },
+    { 26, 35, 36 },
+    { 20, 35, 62 },
+    { 28, 39, 43 },
+    { 18, 25, 56 },
+    { 2, 45, 81 },
+    { 13, 14, 57 },
+    { 32, 51, 52 },
+    { 29, 42, 51 },
+    { 5, 8, 51 },
+    { 26, 32, 64 },
+    { 24, 68, 72 },
+    { 37, 54, 82 },
+    { 19, 38, 76 },
+    { 17, 28, 55 },
+    { 31, 47, 70 },
+    { 41, 50, 58 },
+    { 27, 43, 78 },
+    { 33, 59, 61 },
+    { 30, 44, 60 },
+    { 45, 67, 76 },
+    { 5, 23, 75 },
+    { 7, 9, 77 },
+    { 39, 40, 69 },
+    { 16, 49, 52 },
+    { 41, 65, 67 },
+    { 3, 21, 71 },
+    { 35, 63, 80 },
+    { 12, 28, 46 },
+    { 1, 7, 80 },
+    { 55, 66, 72 },
+    { 4, 37, 49 },
+    { 11, 37, 63 },
+    { 58, 71, 79 },
+    { 2, 25, 78 },
+    { 44, 75, 80 },
+    { 0, 64, 73 },
+    { 6, 17, 76 },
+    { 10, 55, 58 },
+    { 13, 38, 53 },
+    { 15, 36, 65 },
+    { 9, 27, 54 },
+    { 14, 59, 69 },
+    { 16, 24, 81 },
+    { 19, 29, 30 },
+    { 11, 66, 67 },
+    { 22, 74, 79 },
+    { 26, 31, 61 },
+    { 23, 68, 74 },
+    { 18, 20, 70 },
+    { 33, 52, 60 },
+    { 34, 45, 46 },
+    { 32, 58, 75 },
+    { 39, 42, 82 },
+    { 40, 41, 62 },
+    { 48, 74, 82 },
+    { 19, 43, 47 },
+    { 41, 48, 56 },
+};
+
+const uint16_t kFTX_LDPC_Bit_edge[FTX_LDPC_N][3] = {
+    { 96, 278, 455 },
+    { 153, 316, 385 },
+    { 203, 360, 485 },
+    { 0, 272, 279 },
+    { 7, 38, 379 },
+    { 13, 32, 335 },
+    { 19, 215, 298 },
+    { 25, 76, 128 },
+    { 45, 348, 491 },
+    { 51, 397, 429 },
+    { 57, 115, 410 },
+    { 64, 222, 372 },
+    { 70, 228, 361 },
+    { 83, 197, 266 },
+    { 90, 391, 497 },
+    { 102, 172, 479 },
+    { 108, 461, 516 },
+    { 134, 329, 504 },
+    { 141, 184, 209 },
+    { 147, 191, 247 },
+    { 159, 254, 473 },
+    { 166, 354, 436 },
+    { 178, 304, 404 },
+    { 14, 234, 486 },
+    { 26, 240, 510 },
+    { 285, 310, 456 },
+    { 317, 323, 462 },
+    { 341, 442, 448 },
+    { 273, 416, 449 },
+    { 267, 422, 487 },
+    { 1, 198, 366 },
+    { 8, 33, 443 },
+    { 20, 97, 336 },
+    { 39, 405, 417 },
+    { 46, 185, 260 },
+    { 52, 135, 192 },
+    { 58, 109, 474 },
+    { 65, 142, 511 },
+    { 71, 173, 380 },
+    { 77, 324, 492 },
+    { 84, 311, 318 },
+    { 91, 505, 517 },
+    { 103, 179, 373 },
+    { 116, 204, 398 },
+    { 121, 160, 457 },
+    { 129, 210, 248 },
+    { 148, 167, 480 },
+    { 154, 342, 362 },
+    { 216, 330, 411 },
+    { 223, 299, 423 },
+    { 229, 286, 467 },
+    { 235, 280, 292 },
+    { 241, 355, 430 },
+    { 255, 349, 386 },
+    { 122, 305, 331 },
+    { 287, 325, 392 },
+    { 281, 437, 468 },
+    { 168, 217, 498 },
+    { 2, 92, 186 },
+    { 9, 424, 499 },
+    { 15, 224, 319 },
+    { 21, 174, 320 },
+    { 27, 193, 350 },
+    { 34, 123, 230 },
+    { 40, 249, 512 },
+    { 47, 374, 431 },
+    { 53, 59, 306 },
+    { 66, 274, 356 },
+    { 72, 242, 367 },
+    { 78, 149, 343 },
+    { 85, 130, 406 },
+    { 98, 444, 488 },
+    { 104, 187, 475 },
+    { 110, 155, 500 },
+    { 117, 381, 518 },
+    { 136, 236, 481 },
+    { 143, 256, 312 },
+    { 41, 161, 363 },
+    { 180, 199, 506 },
+    { 205, 250, 458 },
+    { 111, 211, 300 },
+    { 79, 261, 399 },
+    { 28, 162, 268 },
+    { 293, 432, 450 },
+    { 337, 344, 438 },
+    { 282, 387, 425 },
+    { 60, 393, 418 },
+    { 86, 412, 451 },
+    { 137, 375, 463 },
+    { 218, 243, 493 },
+    { 3, 288, 400 },
+    { 4, 150, 413 },
+    { 10, 29, 439 },
+    { 16, 194, 407 },
+    { 22, 307, 364 },
+    { 5, 23, 30 },
+    { 35, 376, 419 },
+    { 42, 200, 469 },
+    { 48, 301, 513 },
+    { 54, 219, 257 },
+    { 61, 244, 388 },
+    { 67, 87, 382 },
+    { 73, 445, 464 },
+    { 80, 144, 489 },
+    { 68, 220, 345 },
+    { 93, 99, 494 },
+    { 43, 55, 100 },
+    { 105, 338, 394 },
+    { 112, 313, 357 },
+    { 118, 188, 294 },
+    { 124, 401, 501 },
+    { 131, 175, 433 },
+    { 138, 156, 269 },
+    { 81, 139, 231 },
+    { 11, 295, 321 },
+    { 145, 339, 465 },
+    { 163, 212, 452 },
+    { 169, 225, 232 },
+    { 132, 226, 395 },
+    { 181, 251, 275 },
+    { 119, 164, 358 },
+    { 17, 289, 514 },
+    { 88, 94, 365 },
+    { 206, 326, 332 },
+    { 189, 270, 327 },
+    { 36, 56, 328 },
+    { 170, 207, 408 },
+    { 157, 434, 459 },
+    { 237, 346, 519 },
+    { 125, 245, 482 },
+    { 113, 182, 351 },
+    { 201, 302, 446 },
+    { 262, 322, 368 },
+    { 176, 276, 495 },
+    { 213, 377, 389 },
+    { 195, 283, 383 },
+    { 290, 426, 483 },
+    { 37, 151, 476 },
+    { 49, 62, 490 },
+    { 252, 258, 440 },
+    { 106, 314, 333 },
+    { 263, 414, 427 },
+    { 24, 140, 453 },
+    { 227, 402, 507 },
+    { 82, 183, 296 },
+    { 12, 50, 508 },
+    { 352, 420, 460 },
+    { 31, 238, 315 },
+    { 74, 239, 403 },
+    { 369, 454, 502 },
+    { 18, 165, 496 },
+    { 284, 477, 509 },
+    { 6, 409, 466 },
+    { 44, 114, 484 },
+    { 69, 353, 370 },
+    { 89, 246, 340 },
+    { 101, 233, 415 },
+    { 63, 177, 347 },
+    { 95, 378, 441 },
+    { 107, 158, 515 },
+    { 126, 190, 196 },
+    { 75, 421, 428 },
+    { 146, 470, 503 },
+    { 171, 202, 390 },
+    { 152, 435, 471 },
+    { 120, 133, 447 },
+    { 214, 334, 384 },
+    { 221, 291, 297 },
+    { 208, 371, 478 },
+    { 253, 271, 520 },
+    { 259, 264, 396 },
+    { 308, 472, 521 },
+    { 127, 277, 303 },
+    { 265, 309, 359 },
+};
+
+const uint64_t kFTX_LDPC_Check_mask[FTX_LDPC_M][FTX_LDPC_N_WORDS] = {
+    { 0x1000000200000020ull, 0x0000003100000000ull, 0x0000008000000000ull },
+    { 0x0800000100000010ull, 0x0000000800002000ull, 0x0000400000000000ull },
+    { 0x0400010000000008ull, 0x0000000400000040ull, 0x0000020000000000ull },
+    { 0x0200000080000004ull, 0x0000000300000000ull, 0x0002000000000000ull },
+    { 0x0100008000000002ull, 0x0000200900000000ull, 0x0000100000000000ull },
+    { 0x0400000100000001ull, 0x0000000080000004ull, 0x0040000000000000ull },
+    { 0x0800000040000000ull, 0x8004000040200000ull, 0x0000004000000000ull },
+    { 0x0080000020000000ull, 0x4000000020000000ull, 0x0020400000000000ull },
+    { 0x0040000010000000ull, 0x2000000010200004ull, 0x0000000000000000ull },
+    { 0x0020000008000000ull, 0x2000020008000000ull, 0x0020000400000000ull },
+    { 0x0010000004000000ull, 0x1000000004800000ull, 0x0000002000000000ull },
+    { 0x0008000002000000ull, 0x0800000002000000ull, 0x0000080040000000ull },
+    { 0x0100000001000000ull, 0x0400400001004000ull, 0x0000800000000000ull },
+    { 0x0004000000800000ull, 0x0200010004000020ull, 0x0000001000000000ull },
+    { 0x0002000000400020ull, 0x0000000000400020ull, 0x0000000200000000ull },
+    { 0x8000000080000000ull, 0x0100000000600000ull, 0x0000000800000000ull },
+    { 0x0001000000200000ull, 0x0080000000100000ull, 0x0008000100000000ull },
+    { 0x0000800008000000ull, 0x0040800000080000ull, 0x2000004000000000ull },
+    { 0x0020000000100000ull, 0x0020000000040080ull, 0x0000000004000000ull },
+    { 0x0000000000080201ull, 0x0000000000020000ull, 0x4000000080080000ull },
+    { 0x0100000000040000ull, 0x0200000000010200ull, 0x0000000004000000ull },
+    { 0x0000400010000000ull, 0x001000800000c000ull, 0x0002000000000000ull },
+    { 0x0000200004000000ull, 0x0008000001001000ull, 0x0000000020000000ull },
+    { 0x0000100000020000ull, 0x0400001000000000ull, 0x0040000008000000ull },
+    { 0x4000000000010000ull, 0x0040000000008001ull, 0x0000000100000000ull },
+    { 0x0000080000080000ull, 0x0004200000000880ull, 0x0000020000000000ull },
+    { 0x0000040000020040ull, 0x0000000000000402ull, 0x0000000010000000ull },
+    { 0x0001000002000004ull, 0x0000000000010000ull, 0x0400000400000000ull },
+    { 0x0000020000200000ull, 0x0002000000000100ull, 0x2000800000000000ull },
+    { 0x0000200020000020ull, 0x0080000000040008ull, 0x0000000080000000ull },
+    { 0x0000100010000002ull, 0x0000000400000000ull, 0x0100000080000000ull },
+    { 0x0004000200000000ull, 0x0002000040000000ull, 0x1000000010000000ull },
+    { 0x2000000000100000ull, 0x0001000000000012ull, 0x0000000000800000ull },
+    { 0x0000200000040000ull, 0x0000800000000800ull, 0x0200000002000000ull },
+    { 0x0200000000008040ull, 0x0000004010800000ull, 0x0000000001000000ull },
+    { 0x0010000000004008ull, 0x0000000000000600ull, 0x0001000000000000ull },
+    { 0x0008000000002001ull, 0x0000000000004400ull, 0x0000000800000000ull },
+    { 0x0000010000001000ull, 0x0010000000000000ull, 0x8000180000000000ull },
+    { 0x0000008000000800ull, 0x0800004008000000ull, 0x4000001000000000ull },
+    { 0x0000100000040000ull, 0x8001000000000100ull, 0x0010000000400000ull },
+    { 0x0000080000000400ull, 0x0008000010000000ull, 0x0010000000200000ull },
+    { 0x0000000020000000ull, 0x0000400000000000ull, 0x0804000000240000ull },
+    { 0x0004000400000000ull, 0x0000200000008008ull, 0x0000000000400000ull },
+    { 0x1000000800000000ull, 0x1000000000000100ull, 0x0400000000080000ull },
+    { 0x9000000000001080ull, 0x0000040000000000ull, 0x0100010000000000ull },
+    { 0x0000004000002100ull, 0x0000002000000040ull, 0x0080000001000000ull },
+    { 0x0000000000001000ull, 0x0000100000042000ull, 0x0000800001000000ull },
+    { 0x0200000000004000ull, 0x0000800020000000ull, 0x1000000000080000ull },
+    { 0x0000020000000200ull, 0x2000000200000000ull, 0x0000000000140000ull },
+    { 0x0000004000800000ull, 0x0008000000080000ull, 0x0008100000000000ull },
+    { 0x400000200080000cull, 0x0000000000002000ull, 0x0800000000000000ull },
+    { 0x0000002001000100ull, 0x000000000000001cull, 0x0000000000000000ull },
+    { 0x0000400000008200ull, 0x0000000000000010ull, 0x0008000002000000ull },
+    { 0x0400000080000000ull, 0x0000080000101000ull, 0x0000001000000000ull },
+    { 0x0000001000010000ull, 0x0400080000800000ull, 0x8000000400000000ull },
+    { 0x0080000000000402ull, 0x0000000000000000ull, 0x2000202000000000ull },
+    { 0x0000040000000800ull, 0x1000000000080080ull, 0x0000000000040000ull },
+    { 0x2008000000010000ull, 0x0004000200000020ull, 0x0000000000000000ull },
+    { 0x0000000200000000ull, 0x0800000000000000ull, 0x0800042000800000ull },
+    { 0x0010000000200000ull, 0x4000008080000000ull, 0x0200000200000000ull },
+    { 0x0800000002000000ull, 0x0020000004000000ull, 0x0100000002000000ull },
+    { 0x4000000000000400ull, 0x0000040008000000ull, 0x0200000010000000ull },
+    { 0x0002000000000100ull, 0x0000020000100200ull, 0x0000000000200000ull },
+    { 0x0040000000100000ull, 0x0000402000020000ull, 0x0001080000000000ull },
+    { 0x0000020040000000ull, 0x0200000400000002ull, 0x0000008000000000ull },
+    { 0x0020000000008000ull, 0x0000011000000000ull, 0x0004000800000000ull },
+    { 0x0000000840000000ull, 0x0000020080000000ull, 0x0000200040000000ull },
+    { 0x0000000400004010ull, 0x0000040000000000ull, 0x0084000040000000ull },
+    { 0x0040000000000800ull, 0x4000100000010001ull, 0x0000000008000000ull },
+    { 0x0000040000000080ull, 0x0000080800000000ull, 0x0010000200000000ull },
+    { 0x0000001100000000ull, 0x0100000002000000ull, 0x1000000004000000ull },
+    { 0x0000001800000000ull, 0x0000110000000800ull, 0x0002040000000000ull },
+    { 0x8000004000080000ull, 0x0001000000000001ull, 0x0000200000000000ull },
+    { 0x0000802000000000ull, 0x0000008002001000ull, 0x0000008000000000ull },
+    { 0x0000000000002080ull, 0x0000000040000000ull, 0x0000000028100000ull },
+    { 0x0000080008000000ull, 0x0080000000000000ull, 0x0040010000800000ull },
+    { 0x0001000000020000ull, 0x0010000000000000ull, 0x4080004000000000ull },
+    { 0x2000010400000000ull, 0x0100000001000000ull, 0x0020000000000000ull },
+    { 0x0080000001000000ull, 0x0000004000400000ull, 0x0400020000000000ull },
+    { 0x0002000000000050ull, 0x0040000000020000ull, 0x0000040020000000ull },
+    { 0x0000400000400000ull, 0x0002000000000000ull, 0x0001410000000000ull },
+    { 0x0000008004000000ull, 0x8000000020000040ull, 0x0000000100000000ull },
+    { 0x0000800000400000ull, 0x0020000000000000ull, 0x8000000000500000ull },
+};
+
+const uint64_t kFTX_LDPC_Bit_syndrome[FTX_LDPC_N][FTX_LDPC_M_WORDS] = {
+    { 0x0001000000080000ull, 0x0080000000000000ull },
+    { 0x0000008000002004ull, 0x0000000000000000ull },
+    { 0x0000000080000040ull, 0x0004000000000000ull },
+    { 0x8000000000180000ull, 0x0000000000000000ull },
+    { 0x4200000000000008ull, 0x0000000000000000ull },
+    { 0x2400000000000400ull, 0x0000000000000000ull },
+    { 0x1000000020010000ull, 0x0000000000000000ull },
+    { 0x0808080000000000ull, 0x0000000000000000ull },
+    { 0x0100000000000100ull, 0x0002000000000000ull },
+    { 0x0080000000000001ull, 0x0800000000000000ull },
+    { 0x0040200000000000ull, 0x4000000000000000ull },
+    { 0x0020000010000010ull, 0x0000000000000000ull },
+    { 0x0010000008000040ull, 0x0000000000000000ull },
+    { 0x0004000100200000ull, 0x0000000000000000ull },
+    { 0x0002000000000002ull, 0x0001000000000000ull },
+    { 0x0000801000000000ull, 0x0008000000000000ull },
+    { 0x0000400000000000ull, 0x0040200000000000ull },
+    { 0x0000040000000800ull, 0x0000800000000000ull },
+    { 0x0000020440000000ull, 0x0000000000000000ull },
+    { 0x0000010201000000ull, 0x0000000000000000ull },
+    { 0x0000004000800000ull, 0x0010000000000000ull },
+    { 0x0000002000000080ull, 0x0400000000000000ull },
+    { 0x0000000800008000ull, 0x8000000000000000ull },
+    { 0x2000000004000000ull, 0x0004000000000000ull },
+    { 0x0800000002000000ull, 0x0000400000000000ull },
+    { 0x0000000000044000ull, 0x0080000000000000ull },
+    { 0x0000000000003000ull, 0x0040000000000000ull },
+    { 0x0000000000000200ull, 0x0300000000000000ull },
+    { 0x0000000000100000ull, 0x2100000000000000ull },
+    { 0x0000000000200000ull, 0x1004000000000000ull },
+    { 0x8000000100000020ull, 0x0000000000000000ull },
+    { 0x4400000000000000ull, 0x0200000000000000ull },
+    { 0x1001000000000400ull, 0x0000000000000000ull },
+    { 0x0200000000000000ull, 0xa000000000000000ull },
+    { 0x0100000400400000ull, 0x0000000000000000ull },
+    { 0x0080040200000000ull, 0x0000000000000000ull },
+    { 0x0040400000000000ull, 0x0010000000000000ull },
+    { 0x0020020000000000ull, 0x0000400000000000ull },
+    { 0x0010001000000008ull, 0x0000000000000000ull },
+    { 0x0008000000001000ull, 0x0002000000000000ull },
+    { 0x0004000000006000ull, 0x0000000000000000ull },
+    { 0x0002000000000000ull, 0x0000a00000000000ull },
+    { 0x0000800800000010ull, 0x0000000000000000ull },
+    { 0x0000200080000001ull, 0x0000000000000000ull },
+    { 0x0000104000000000ull, 0x0080000000000000ull },
+    { 0x0000080041000000ull, 0x0000000000000000ull },
+    { 0x0000012000000000ull, 0x0008000000000000ull },
+    { 0x0000008000000240ull, 0x0000000000000000ull },
+    { 0x0000000020000800ull, 0x4000000000000000ull },
+    { 0x0000000010010000ull, 0x1000000000000000ull },
+    { 0x0000000008040000ull, 0x0020000000000000ull },
+    { 0x00000000040a0000ull, 0x0000000000000000ull },
+    { 0x0000000002000080ull, 0x0800000000000000ull },
+    { 0x0000000000800104ull, 0x0000000000000000ull },
+    { 0x0000100000008800ull, 0x0000000000000000ull },
+    { 0x0000000000041002ull, 0x0000000000000000ull },
+    { 0x0000000000080000ull, 0x0420000000000000ull },
+    { 0x0000002020000000ull, 0x0001000000000000ull },
+    { 0x8002000400000000ull, 0x0000000000000000ull },
+    { 0x4000000000000000ull, 0x1001000000000000ull },
+    { 0x2000000010002000ull, 0x0000000000000000ull },
+    { 0x1000001000002000ull, 0x0000000000000000ull },
+    { 0x0800000200000100ull, 0x0000000000000000ull },
+    { 0x0400100008000000ull, 0x0000000000000000ull },
+    { 0x0200000001000000ull, 0x0000400000000000ull },
+    { 0x0100000000000010ull, 0x0800000000000000ull },
+    { 0x00c0000000008000ull, 0x0000000000000000ull },
+    { 0x0020000000100080ull, 0x0000000000000000ull },
+    { 0x0010000002000020ull, 0x0000000000000000ull },
+    { 0x0008010000000200ull, 0x0000000000000000ull },
+    { 0x0004080000000000ull, 0x8000000000000000ull },
+    { 0x0001000000000000ull, 0x0204000000000000ull },
+    { 0x0000800400000000ull, 0x0010000000000000ull },
+    { 0x0000408000000000ull, 0x0001000000000000ull },
+    { 0x0000200000000008ull, 0x0000200000000000ull },
+    { 0x0000040004000000ull, 0x0008000000000000ull },
+    { 0x0000020000804000ull, 0x0000000000000000ull },
+    { 0x0200004000000040ull, 0x0000000000000000ull },
+    { 0x0000000900000000ull, 0x0000800000000000ull },
+    { 0x0000000081000000ull, 0x0080000000000000ull },
+    { 0x0000400040010000ull, 0x0000000000000000ull },
+    { 0x0008000000400001ull, 0x0000000000000000ull },
+    { 0x0800004000200000ull, 0x0000000000000000ull },
+    { 0x0000000000020000ull, 0x0900000000000000ull },
+    { 0x0000000000000600ull, 0x0400000000000000ull },
+    { 0x0000000000080004ull, 0x1000000000000000ull },
+    { 0x0040000000000002ull, 0x2000000000000000ull },
+    { 0x0004000000000000ull, 0x4100000000000000ull },
+    { 0x0000040000000010ull, 0x0040000000000000ull },
+    { 0x0000000022000000ull, 0x0002000000000000ull },
+    { 0x8000000000040001ull, 0x0000000000000000ull },
+    { 0x8000010000000000ull, 0x4000000000000000ull },
+    { 0x4800000000000000ull, 0x0400000000000000ull },
+    { 0x2000000200000000ull, 0x8000000000000000ull },
+    { 0x1000000000008040ull, 0x0000000000000000ull },
+    { 0x9800000000000000ull, 0x0000000000000000ull },
+    { 0x0400000000000010ull, 0x2000000000000000ull },
+    { 0x0200000100000000ull, 0x0020000000000000ull },
+    { 0x0100000000010000ull, 0x0000400000000000ull },
+    { 0x0080000020800000ull, 0x0000000000000000ull },
+    { 0x0040000002000004ull, 0x0000000000000000ull },
+    { 0x0024000000000008ull, 0x0000000000000000ull },
+    { 0x0010000000000000ull, 0x0240000000000000ull },
+    { 0x0008020000000000ull, 0x0004000000000000ull },
+    { 0x0020000020000200ull, 0x0000000000000000ull },
+    { 0x0003000000000000ull, 0x0002000000000000ull },
+    { 0x0281000000000000ull, 0x0000000000000000ull },
+    { 0x0000800000000402ull, 0x0000000000000000ull },
+    { 0x0000400000004080ull, 0x0000000000000000ull },
+    { 0x0000200400020000ull, 0x0000000000000000ull },
+    { 0x0000100000000001ull, 0x0001000000000000ull },
+    { 0x0000081000000000ull, 0x0800000000000000ull },
+    { 0x0000048000200000ull, 0x0000000000000000ull },
+    { 0x0008040008000000ull, 0x0000000000000000ull },
+    { 0x4000000000022000ull, 0x0000000000000000ull },
+    { 0x0000020000000400ull, 0x0040000000000000ull },
+    { 0x0000004040000000ull, 0x0100000000000000ull },
+    { 0x0000002018000000ull, 0x0000000000000000ull },
+    { 0x0000080010000002ull, 0x0000000000000000ull },
+    { 0x0000000801100000ull, 0x0000000000000000ull },
+    { 0x0000204000000080ull, 0x0000000000000000ull },
+    { 0x2000000000040000ull, 0x0000400000000000ull },
+    { 0x0006000000000040ull, 0x0000000000000000ull },
+    { 0x0000000080001800ull, 0x0000000000000000ull },
+    { 0x0000000400201000ull, 0x0000000000000000ull },
+    { 0x0480000000001000ull, 0x0000000000000000ull },
+    { 0x0000002080000000ull, 0x8000000000000000ull },
+    { 0x0000008000000000ull, 0x0880000000000000ull },
+    { 0x0000000004000200ull, 0x0000200000000000ull },
+    { 0x0000100002000000ull, 0x0008000000000000ull },
+    { 0x0000400800000100ull, 0x0000000000000000ull },
+    { 0x0000000100010000ull, 0x0200000000000000ull },
+    { 0x0000000000402020ull, 0x0000000000000000ull },
+    { 0x0000001000100000ull, 0x0002000000000000ull },
+    { 0x0000000040000014ull, 0x0000000000000000ull },
+    { 0x0000000200080008ull, 0x0000000000000000ull },
+    { 0x0000000000040000ull, 0x1008000000000000ull },
+    { 0x0400010000000000ull, 0x0010000000000000ull },
+    { 0x0140000000000000ull, 0x0004000000000000ull },
+    { 0x0000000001800000ull, 0x0400000000000000ull },
+    { 0x0000800000004800ull, 0x0000000000000000ull },
+    { 0x0000000000400000ull, 0x5000000000000000ull },
+    { 0x1000040000000000ull, 0x0100000000000000ull },
+    { 0x0000000010000001ull, 0x0000800000000000ull },
+    { 0x0008000800020000ull, 0x0000000000000000ull },
+    { 0x4100000000000000ull, 0x0000800000000000ull },
+    { 0x0000000000000100ull, 0x2080000000000000ull },
+    { 0x0800000004004000ull, 0x0000000000000000ull },
+    { 0x0010000004000001ull, 0x0000000000000000ull },
+    { 0x0000000000000020ull, 0x0101000000000000ull },
+    { 0x2000004000000000ull, 0x0002000000000000ull },
+    { 0x0000000000080000ull, 0x0010800000000000ull },
+    { 0x8000000000000000ull, 0x8040000000000000ull },
+    { 0x0200400000000000ull, 0x0008000000000000ull },
+    { 0x0020000000000120ull, 0x0000000000000000ull },
+    { 0x0004000002000400ull, 0x0000000000000000ull },
+    { 0x0001000008000000ull, 0x4000000000000000ull },
+    { 0x0040001000000200ull, 0x0000000000000000ull },
+    { 0x0002000000000010ull, 0x0400000000000000ull },
+    { 0x0000808000000000ull, 0x0000400000000000ull },
+    { 0x0000100600000000ull, 0x0000000000000000ull },
+    { 0x0010000000000000ull, 0x3000000000000000ull },
+    { 0x0000020000000000ull, 0x0021000000000000ull },
+    { 0x0000002100000004ull, 0x0000000000000000ull },
+    { 0x0000010000000000ull, 0x0820000000000000ull },
+    { 0x0000280000000000ull, 0x0200000000000000ull },
+    { 0x0000000040000808ull, 0x0000000000000000ull },
+    { 0x0000000020060000ull, 0x0000000000000000ull },
+    { 0x0000000080000020ull, 0x0010000000000000ull },
+    { 0x0000000001200000ull, 0x0000200000000000ull },
+    { 0x0000000000c00002ull, 0x0000000000000000ull },
+    { 0x0000000000008000ull, 0x0020200000000000ull },
+    { 0x0000100000110000ull, 0x0000000000000000ull },
+    { 0x0000000000408080ull, 0x0000000000000000ull },
+};
@@ -44,6 +44,10 @@ extern "C"
 #define FTX_LDPC_M       (83)                   ///< Number of LDPC checksum bits (FTX_LDPC_N - FTX_LDPC_K)
 #define FTX_LDPC_N_BYTES ((FTX_LDPC_N + 7) / 8) ///< Number of whole bytes needed to store 174 bits (full message)
 #define FTX_LDPC_K_BYTES ((FTX_LDPC_K + 7) / 8) ///< Number of whole bytes needed to store 91 bits (payload + CRC only)
+#define FTX_LDPC_N_WORDS ((FTX_LDPC_N + 63) / 64) ///< Number of 64-bit words needed to store 174 bits (full message)
+#define FTX_LDPC_M_WORDS ((FTX_LDPC_M + 63) / 64) ///< Number of 64-bit words needed to store 83 parity check results
+#define FTX_LDPC_NUM_EDGES (522)               ///< Number of edges in the LDPC parity check graph (3 per codeword bit)
+#define FTX_LDPC_M_PADDED (88)                 ///< Number of parity checks padded to a multiple of 8 (vector lanes)
 
 // Define CRC parameters
 #define FT8_CRC_POLYNOMIAL ((uint16_t)0x2757u) ///< CRC-14 polynomial without the leading (MSB) 1
@@ -83,6 +87,31 @@ extern const uint8_t kFTX_LDPC_Mn[FTX_LDPC_N][3];
 /// Number of rows (columns in C/C++) in the array Nm.
 extern const uint8_t kFTX_LDPC_Num_rows[FTX_LDPC_M];
 
+/// Edge-indexed form of the parity check graph, generated from Nm and Mn by utils/gen_ldpc_tables.py.
+/// All indices are 0-based. Edges are numbered by parity check: the edges of check m are
+/// kFTX_LDPC_Check_offset[m] .. kFTX_LDPC_Check_offset[m + 1] - 1, in the order of Nm.
+extern const uint16_t kFTX_LDPC_Check_offset[FTX_LDPC_M + 1];
+
+/// Codeword bit of each edge
+extern const uint8_t kFTX_LDPC_Edge_bit[FTX_LDPC_NUM_EDGES];
+
+/// Position of each edge in the per-bit order (3 * bit + index in Mn)
+extern const uint16_t kFTX_LDPC_Edge_slot[FTX_LDPC_NUM_EDGES];
+
+/// Parity checks of each codeword bit (Mn, 0-based)
+extern const uint8_t kFTX_LDPC_Bit_check[FTX_LDPC_N][3];
+
+/// Edges of each codeword bit, in the order of Mn
+extern const uint16_t kFTX_LDPC_Bit_edge[FTX_LDPC_N][3];
+
+/// Rows of the parity check matrix in bit-packed form, also generated by utils/gen_ldpc_tables.py.
+/// Codeword bit n is stored in word n / 64 starting from the MSB, i.e. in the same order as the
+/// byte-packed tables.
+extern const uint64_t kFTX_LDPC_Check_mask[FTX_LDPC_M][FTX_LDPC_N_WORDS];
+
+/// Parity checks of each codeword bit, packed in the same way as a syndrome of FTX_LDPC_M bits
+extern const uint64_t kFTX_LDPC_Bit_syndrome[FTX_LDPC_N][FTX_LDPC_M_WORDS];
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,8 +4,20 @@
 #include "ldpc.h"
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
 #include <math.h>
 
+#ifdef FTX_USE_THREADS
+#include <pthread.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 // #define LOG_LEVEL LOG_DEBUG
 // #include "debug.h"
 
@@ -32,227 +44,1686 @@ static const float db_power_sum[40] = {
 static void ft4_extract_likelihood(const ftx_waterfall_t* wf, const ftx_candidate_t* cand, float* log174);
 static void ft8_extract_likelihood(const ftx_waterfall_t* wf, const ftx_candidate_t* cand, float* log174);
 
-/// Packs a string of bits each represented as a zero/non-zero byte in bit_array[],
+/// Packs the first num_bits of a string of bits packed into 64-bit words (MSB first, as output by the LDPC decoder),
 /// as a string of packed bits starting from the MSB of the first byte of packed[]
-/// @param[in] plain Array of bits (0 and nonzero values) with num_bits entires
-/// @param[in] num_bits Number of bits (entries) passed in bit_array
-/// @param[out] packed Byte-packed bits representing the data in bit_array
-static void pack_bits(const uint8_t bit_array[], int num_bits, uint8_t packed[]);
+/// @param[in] bit_words Word-packed bits with at least num_bits entries
+/// @param[in] num_bits Number of bits to pack, the remaining bits of the last byte are cleared
+/// @param[out] packed Byte-packed bits representing the data in bit_words
+static void pack_bits(const uint64_t bit_words[], int num_bits, uint8_t packed[]);
 
 static float max2(float a, float b);
 static float max4(float a, float b, float c, float d);
 static void heapify_down(ftx_candidate_t heap[], int heap_size);
 static void heapify_up(ftx_candidate_t heap[], int heap_size);
+static void heap_sort(ftx_candidate_t heap[], int heap_size);
 
 static void ftx_normalize_logl(float* log174);
 static void ft4_extract_symbol(const WF_ELEM_T* wf, float* logl);
 static void ft8_extract_symbol(const WF_ELEM_T* wf, float* logl);
 static void ft8_decode_multi_symbols(const WF_ELEM_T* wf, int num_bins, int n_syms, int bit_idx, float* log174);
 
-static const WF_ELEM_T* get_cand_mag(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate)
+/// Position of the first block of the view in the mag array
+static int get_view_first(const ftx_waterfall_t* wf)
+{
+    return wf->block_start % wf->max_blocks;
+}
+
+/// Get the magnitudes of the candidate (frequency offset and subdivisions) in a block of the view,
+/// taking care of the wrap-around of the ring buffer
+/// @param[in] wf Waterfall
+/// @param[in] view_first Position of the first block of the view (see get_view_first())
+/// @param[in] candidate Candidate
+/// @param[in] block Index of the block in the view (0 <= block < wf->num_blocks)
+static inline const WF_ELEM_T* get_cand_mag(const ftx_waterfall_t* wf, int view_first, const ftx_candidate_t* candidate, int block)
+{
+    int index = view_first + block;
+    if (index >= wf->max_blocks)
+        index -= wf->max_blocks;
+    return ftx_waterfall_row(wf, index, candidate->time_sub, candidate->freq_sub) + candidate->freq_offset;
+}
+
+int ftx_waterfall_set_view(ftx_waterfall_t* wf, int block_start, int num_blocks)
+{
+    // Older blocks have been overwritten
+    int oldest = (wf->block_count > wf->max_blocks) ? (wf->block_count - wf->max_blocks) : 0;
+    if (block_start < oldest)
+        block_start = oldest;
+    if (block_start > wf->block_count)
+        block_start = wf->block_count;
+    if (num_blocks > wf->block_count - block_start)
+        num_blocks = wf->block_count - block_start;
+    if (num_blocks < 0)
+        num_blocks = 0;
+    wf->block_start = block_start;
+    wf->num_blocks = num_blocks;
+    return num_blocks;
+}
+
+// Compact (4-bit) waterfall rows hold the level of every bin above the row base, in magnitude code units (0.5 dB):
+// codes 0..7 in steps of 4 (2 dB), codes 8..15 in steps of 8 (4 dB), i.e. level = 4 * (code + max(code - 7, 0)).
+#define U4_NUM_FINE 7
+// Distance of the row base below the average magnitude of the row (mostly noise), in magnitude code units
+#define U4_BASE_OFFSET 8
+// Candidate frequency offsets scored from one unpacked tile
+#define U4_TILE_BINS 16
+// Bins per tile row, starting 2 bins below the first candidate (enough for the 8 tones and their neighbors)
+#define U4_TILE_WIDTH 32
+// Tile rows, enough to cover the sync symbols of the longest (FT4) message from time_offset - 1
+#define U4_TILE_ROWS (FT4_NN + 2)
+
+#ifndef WATERFALL_USE_PHASE
+// Round a level above the row base to the nearest 4-bit code
+static uint8_t u4_encode(int level)
+{
+    if (level <= 0)
+        return 0;
+    if (level < 4 * U4_NUM_FINE + 4)
+    {
+        // Fine steps up to halfway to the first coarse level
+        int code = (level + 2) >> 2;
+        return (code < U4_NUM_FINE) ? code : U4_NUM_FINE;
+    }
+    int code = U4_NUM_FINE + ((level - 4 * U4_NUM_FINE + 4) >> 3);
+    return (code < 15) ? code : 15;
+}
+
+/// Unpack 32 magnitude codes (bins first_bin .. first_bin + 31) from a compact row.
+/// first_bin must be even; it may be -2, and the bins past the end of the row are undefined.
+static inline void u4_unpack(const uint8_t* row, int first_bin, uint8_t* out)
+{
+    const uint8_t* packed = row + 1 + (first_bin / 2);
+#if defined(__SSE2__)
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i fine = _mm_set1_epi8(U4_NUM_FINE);
+    const __m128i base = _mm_set1_epi8((char)row[0]);
+    __m128i bytes = _mm_loadu_si128((const __m128i*)packed);
+    __m128i lo = _mm_and_si128(bytes, mask);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+    __m128i code0 = _mm_unpacklo_epi8(lo, hi);
+    __m128i code1 = _mm_unpackhi_epi8(lo, hi);
+    // level = 4 * (code + max(code - 7, 0)) stays below 128, so the 16-bit shift does not cross bytes
+    __m128i level0 = _mm_slli_epi16(_mm_add_epi8(code0, _mm_subs_epu8(code0, fine)), 2);
+    __m128i level1 = _mm_slli_epi16(_mm_add_epi8(code1, _mm_subs_epu8(code1, fine)), 2);
+    _mm_storeu_si128((__m128i*)out, _mm_adds_epu8(base, level0));
+    _mm_storeu_si128((__m128i*)(out + 16), _mm_adds_epu8(base, level1));
+#elif defined(__ARM_NEON)
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+    const uint8x16_t fine = vdupq_n_u8(U4_NUM_FINE);
+    const uint8x16_t base = vdupq_n_u8(row[0]);
+    uint8x16_t bytes = vld1q_u8(packed);
+    uint8x16x2_t code = vzipq_u8(vandq_u8(bytes, mask), vshrq_n_u8(bytes, 4));
+    uint8x16_t level0 = vshlq_n_u8(vaddq_u8(code.val[0], vqsubq_u8(code.val[0], fine)), 2);
+    uint8x16_t level1 = vshlq_n_u8(vaddq_u8(code.val[1], vqsubq_u8(code.val[1], fine)), 2);
+    vst1q_u8(out, vqaddq_u8(base, level0));
+    vst1q_u8(out + 16, vqaddq_u8(base, level1));
+#else
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int nibble = 0; nibble < 2; ++nibble)
+        {
+            int code = (packed[i] >> (4 * nibble)) & 0x0F;
+            int level = 4 * (code + ((code > U4_NUM_FINE) ? (code - U4_NUM_FINE) : 0));
+            int value = row[0] + level;
+            out[2 * i + nibble] = (value > 255) ? 255 : value;
+        }
+    }
+#endif
+}
+
+void ftx_waterfall_store_row(ftx_waterfall_t* wf, int block, int time_sub, int freq_sub, const uint8_t* mag, int mag_step)
+{
+    uint8_t* row = ftx_waterfall_row(wf, block, time_sub, freq_sub);
+    if (wf->format != FTX_WATERFALL_FORMAT_U4)
+    {
+        for (int bin = 0; bin < wf->num_bins; ++bin)
+        {
+            row[bin] = mag[bin * mag_step];
+        }
+        return;
+    }
+
+    int sum = 0;
+    for (int bin = 0; bin < wf->num_bins; ++bin)
+    {
+        sum += mag[bin * mag_step];
+    }
+    int base = (sum / wf->num_bins) - U4_BASE_OFFSET;
+    if (base < 0)
+        base = 0;
+    row[0] = base;
+    for (int bin = 0; bin < wf->num_bins; bin += 2)
+    {
+        uint8_t lo = u4_encode(mag[bin * mag_step] - base);
+        uint8_t hi = (bin + 1 < wf->num_bins) ? u4_encode(mag[(bin + 1) * mag_step] - base) : 0;
+        row[1 + bin / 2] = lo | (hi << 4);
+    }
+}
+
+/// Unpack the rows of a compact waterfall under the sync symbols of the candidates at
+/// freq_offset .. freq_offset + U4_TILE_BINS - 1 (freq_offset being a multiple of U4_TILE_BINS).
+/// Row r of the tile holds block time_offset - 1 + r of the view, starting 2 bins below freq_offset.
+static void u4_fill_tile(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate, uint8_t* tile)
+{
+    const bool is_ft4 = (wf->protocol == FTX_PROTOCOL_FT4);
+    const int num_sync = is_ft4 ? FT4_NUM_SYNC : FT8_NUM_SYNC;
+    const int length_sync = is_ft4 ? FT4_LENGTH_SYNC : FT8_LENGTH_SYNC;
+    const int sync_offset = is_ft4 ? FT4_SYNC_OFFSET : FT8_SYNC_OFFSET;
+    const int first_block = candidate->time_offset + (is_ft4 ? 1 : 0);
+    const int view_first = get_view_first(wf);
+
+    for (int m = 0; m < num_sync; ++m)
+    {
+        for (int k = 0; k < length_sync; ++k)
+        {
+            int block_abs = first_block + (sync_offset * m) + k;
+            if ((block_abs < 0) || (block_abs >= wf->num_blocks))
+                continue;
+            int index = view_first + block_abs;
+            if (index >= wf->max_blocks)
+                index -= wf->max_blocks;
+            const uint8_t* row = ftx_waterfall_row(wf, index, candidate->time_sub, candidate->freq_sub);
+            u4_unpack(row, candidate->freq_offset - 2, tile + (block_abs - candidate->time_offset + 1) * U4_TILE_WIDTH);
+        }
+    }
+}
+
+/// Column of the candidate frequency offset in the tile filled by u4_fill_tile()
+static inline int u4_tile_column(const ftx_candidate_t* candidate)
+{
+    return (candidate->freq_offset % U4_TILE_BINS) + 2;
+}
+#endif
+
+/// Get the magnitudes of the candidate tones in a block of the view, like get_cand_mag().
+/// Compact rows are unpacked into scratch (U4_TILE_WIDTH entries).
+static inline const WF_ELEM_T* get_cand_tones(const ftx_waterfall_t* wf, int view_first, const ftx_candidate_t* candidate, int block, WF_ELEM_T* scratch)
+{
+#ifndef WATERFALL_USE_PHASE
+    if (wf->format == FTX_WATERFALL_FORMAT_U4)
+    {
+        int index = view_first + block;
+        if (index >= wf->max_blocks)
+            index -= wf->max_blocks;
+        const uint8_t* row = ftx_waterfall_row(wf, index, candidate->time_sub, candidate->freq_sub);
+        u4_unpack(row, candidate->freq_offset & ~1, scratch);
+        return scratch + (candidate->freq_offset & 1);
+    }
+#endif
+    return get_cand_mag(wf, view_first, candidate, block);
+}
+
+// With wrap = false, the magnitudes of block b (of the view) are at mag_first + (b - block_first) * block_step.
+// With wrap = true, they are looked up in the ring buffer for every block.
+static inline int ft8_sync_score_view(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate, const WF_ELEM_T* mag_first, int block_first, int block_step, bool wrap)
+{
+    int score = 0;
+    int num_average = 0;
+    const int view_first = get_view_first(wf);
+
+    // Compute average score over sync symbols (m+k = 0-7, 36-43, 72-79)
+    for (int m = 0; m < FT8_NUM_SYNC; ++m)
+    {
+        for (int k = 0; k < FT8_LENGTH_SYNC; ++k)
+        {
+            int block = (FT8_SYNC_OFFSET * m) + k;          // relative to the message
+            int block_abs = candidate->time_offset + block; // relative to the captured signal
+            // Check for time boundaries
+            if (block_abs < 0)
+                continue;
+            if (block_abs >= wf->num_blocks)
+                break;
+
+            // Get the pointer to symbol 'block' of the candidate
+            const WF_ELEM_T* p8 = wrap ? get_cand_mag(wf, view_first, candidate, block_abs) : (mag_first + (block_abs - block_first) * block_step);
+
+            // Weighted difference between the expected and all other symbols
+            // Does not work as well as the alternative score below
+            // score += 8 * p8[kFT8_Costas_pattern[k]] -
+            //          p8[0] - p8[1] - p8[2] - p8[3] -
+            //          p8[4] - p8[5] - p8[6] - p8[7];
+            // ++num_average;
+
+            // Check only the neighbors of the expected symbol frequency- and time-wise
+            int sm = kFT8_Costas_pattern[k]; // Index of the expected bin
+            if (sm > 0)
+            {
+                // look at one frequency bin lower
+                score += WF_ELEM_MAG_INT(p8[sm]) - WF_ELEM_MAG_INT(p8[sm - 1]);
+                ++num_average;
+            }
+            if (sm < 7)
+            {
+                // look at one frequency bin higher
+                score += WF_ELEM_MAG_INT(p8[sm]) - WF_ELEM_MAG_INT(p8[sm + 1]);
+                ++num_average;
+            }
+            if ((k > 0) && (block_abs > 0))
+            {
+                // look one symbol back in time
+                const WF_ELEM_T* p8_prev = wrap ? get_cand_mag(wf, view_first, candidate, block_abs - 1) : (p8 - block_step);
+                score += WF_ELEM_MAG_INT(p8[sm]) - WF_ELEM_MAG_INT(p8_prev[sm]);
+                ++num_average;
+            }
+            if (((k + 1) < FT8_LENGTH_SYNC) && ((block_abs + 1) < wf->num_blocks))
+            {
+                // look one symbol forward in time
+                const WF_ELEM_T* p8_next = wrap ? get_cand_mag(wf, view_first, candidate, block_abs + 1) : (p8 + block_step);
+                score += WF_ELEM_MAG_INT(p8[sm]) - WF_ELEM_MAG_INT(p8_next[sm]);
+                ++num_average;
+            }
+        }
+    }
+
+    if (num_average > 0)
+        score /= num_average;
+
+    return score;
+}
+
+static int ft8_sync_score(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate)
+{
+    const int view_first = get_view_first(wf);
+    if (view_first + wf->num_blocks > wf->max_blocks)
+        return ft8_sync_score_view(wf, candidate, NULL, 0, 0, true);
+    return ft8_sync_score_view(wf, candidate, get_cand_mag(wf, view_first, candidate, 0), 0, ftx_waterfall_block_step(wf), false);
+}
+
+#ifndef WATERFALL_USE_PHASE
+static int ft8_sync_score_tile(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate, const uint8_t* tile)
+{
+    return ft8_sync_score_view(wf, candidate, tile + u4_tile_column(candidate), candidate->time_offset - 1, U4_TILE_WIDTH, false);
+}
+#endif
+
+// With wrap = false, the magnitudes of block b (of the view) are at mag_first + (b - block_first) * block_step.
+// With wrap = true, they are looked up in the ring buffer for every block.
+static inline int ft4_sync_score_view(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate, const WF_ELEM_T* mag_first, int block_first, int block_step, bool wrap)
+{
+    int score = 0;
+    int num_average = 0;
+    const int view_first = get_view_first(wf);
+
+    // Compute average score over sync symbols (block = 1-4, 34-37, 67-70, 100-103)
+    for (int m = 0; m < FT4_NUM_SYNC; ++m)
+    {
+        for (int k = 0; k < FT4_LENGTH_SYNC; ++k)
+        {
+            int block = 1 + (FT4_SYNC_OFFSET * m) + k;
+            int block_abs = candidate->time_offset + block;
+            // Check for time boundaries
+            if (block_abs < 0)
+                continue;
+            if (block_abs >= wf->num_blocks)
+                break;
+
+            // Get the pointer to symbol 'block' of the candidate
+            const WF_ELEM_T* p4 = wrap ? get_cand_mag(wf, view_first, candidate, block_abs) : (mag_first + (block_abs - block_first) * block_step);
+
+            int sm = kFT4_Costas_pattern[m][k]; // Index of the expected bin
+
+            // score += (4 * p4[sm]) - p4[0] - p4[1] - p4[2] - p4[3];
+            // num_average += 4;
+
+            // Check only the neighbors of the expected symbol frequency- and time-wise
+            if (sm > 0)
+            {
+                // look at one frequency bin lower
+                score += WF_ELEM_MAG_INT(p4[sm]) - WF_ELEM_MAG_INT(p4[sm - 1]);
+                ++num_average;
+            }
+            if (sm < 3)
+            {
+                // look at one frequency bin higher
+                score += WF_ELEM_MAG_INT(p4[sm]) - WF_ELEM_MAG_INT(p4[sm + 1]);
+                ++num_average;
+            }
+            if ((k > 0) && (block_abs > 0))
+            {
+                // look one symbol back in time
+                const WF_ELEM_T* p4_prev = wrap ? get_cand_mag(wf, view_first, candidate, block_abs - 1) : (p4 - block_step);
+                score += WF_ELEM_MAG_INT(p4[sm]) - WF_ELEM_MAG_INT(p4_prev[sm]);
+                ++num_average;
+            }
+            if (((k + 1) < FT4_LENGTH_SYNC) && ((block_abs + 1) < wf->num_blocks))
+            {
+                // look one symbol forward in time
+                const WF_ELEM_T* p4_next = wrap ? get_cand_mag(wf, view_first, candidate, block_abs + 1) : (p4 + block_step);
+                score += WF_ELEM_MAG_INT(p4[sm]) - WF_ELEM_MAG_INT(p4_next[sm]);
+                ++num_average;
+            }
+        }
+    }
+
+    if (num_average > 0)
+        score /= num_average;
+
+    return score;
+}
+
+static int ft4_sync_score(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate)
+{
+    const int view_first = get_view_first(wf);
+    if (view_first + wf->num_blocks > wf->max_blocks)
+        return ft4_sync_score_view(wf, candidate, NULL, 0, 0, true);
+    return ft4_sync_score_view(wf, candidate, get_cand_mag(wf, view_first, candidate, 0), 0, ftx_waterfall_block_step(wf), false);
+}
+
+#ifndef WATERFALL_USE_PHASE
+static int ft4_sync_score_tile(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate, const uint8_t* tile)
+{
+    return ft4_sync_score_view(wf, candidate, tile + u4_tile_column(candidate), candidate->time_offset - 1, U4_TILE_WIDTH, false);
+}
+#endif
+
+// Add a candidate to the min-heap of the best num_candidates candidates, return the new heap size
+static int heap_add(ftx_candidate_t heap[], int heap_size, int num_candidates, const ftx_candidate_t* candidate)
+{
+    // If the heap is full AND the current candidate is better than
+    // the worst in the heap, we remove the worst and make space
+    if ((heap_size == num_candidates) && (candidate->score > heap[0].score))
+    {
+        --heap_size;
+        heap[0] = heap[heap_size];
+        heapify_down(heap, heap_size);
+    }
+
+    // If there's free space in the heap, we add the current candidate
+    if (heap_size < num_candidates)
+    {
+        heap[heap_size] = *candidate;
+        ++heap_size;
+        heapify_up(heap, heap_size);
+    }
+    return heap_size;
+}
+
+// Candidates inserted into a heap, in the order of insertion (see ftx_find_candidates_parallel())
+typedef struct
+{
+    ftx_candidate_t* items; ///< Logged candidates (capacity entries)
+    int capacity;           ///< Number of entries allocated
+    int size;               ///< Number of insertions, the log is incomplete if larger than capacity
+} candidate_log_t;
+
+// Same as heap_add(), and append the candidate to the log (if not NULL) when it enters the heap
+static int heap_add_logged(ftx_candidate_t heap[], int heap_size, int num_candidates, const ftx_candidate_t* candidate, candidate_log_t* log)
+{
+    if ((log != NULL) && ((heap_size < num_candidates) || (candidate->score > heap[0].score)))
+    {
+        if (log->size < log->capacity)
+            log->items[log->size] = *candidate;
+        ++log->size;
+    }
+    return heap_add(heap, heap_size, num_candidates, candidate);
+}
+
+#if !defined(WATERFALL_USE_PHASE) && (defined(__SSE2__) || defined(__ARM_NEON))
+#define SYNC_SIMD
+// Number of consecutive frequency offsets scored at once by the vectorized sync score
+#define SYNC_LANES 16
+
+// Vectors of 8 int16 lanes
+#if defined(__SSE2__)
+typedef __m128i sync_vec_t;
+#define SYNC_ZERO()     _mm_setzero_si128()
+#define SYNC_ADD(a, b)  _mm_adds_epi16(a, b)
+#define SYNC_SUB(a, b)  _mm_subs_epi16(a, b)
+#define SYNC_STORE(p, a) _mm_storeu_si128((__m128i*)(p), a)
+#define SYNC_LOAD(p)    _mm_loadu_si128((const __m128i*)(p))
+// Widen 16 consecutive magnitudes to two vectors
+static inline void sync_load(const uint8_t* p, sync_vec_t v[2])
+{
+    __m128i bytes = _mm_loadu_si128((const __m128i*)p);
+    v[0] = _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+    v[1] = _mm_unpackhi_epi8(bytes, _mm_setzero_si128());
+}
+#else
+typedef int16x8_t sync_vec_t;
+#define SYNC_ZERO()     vdupq_n_s16(0)
+#define SYNC_ADD(a, b)  vqaddq_s16(a, b)
+#define SYNC_SUB(a, b)  vqsubq_s16(a, b)
+#define SYNC_STORE(p, a) vst1q_s16(p, a)
+#define SYNC_LOAD(p)    vld1q_s16(p)
+static inline void sync_load(const uint8_t* p, sync_vec_t v[2])
+{
+    uint8x16_t bytes = vld1q_u8(p);
+    v[0] = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(bytes)));
+    v[1] = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(bytes)));
+}
+#endif
+
+// Add the difference of magnitudes at p_sym and p_other in all lanes to the score sums
+static inline void sync_add_diff(sync_vec_t sum[2], const sync_vec_t sym[2], const uint8_t* p_other)
+{
+    sync_vec_t other[2];
+    sync_load(p_other, other);
+    sum[0] = SYNC_ADD(sum[0], SYNC_SUB(sym[0], other[0]));
+    sum[1] = SYNC_ADD(sum[1], SYNC_SUB(sym[1], other[1]));
+}
+
+/// Vectorized ft8_sync_score_view() / ft4_sync_score_view() for the SYNC_LANES frequency offsets starting at
+/// candidate->freq_offset. The time boundary checks do not depend on the frequency offset, so all lanes share
+/// the same terms. Stores the sum of the score terms of every lane, and returns the number of terms.
+static inline int sync_score_lanes(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate, const uint8_t* mag_first, int block_first, int block_step, bool is_ft4, bool wrap, int16_t sums[SYNC_LANES])
+{
+    const int num_sync = is_ft4 ? FT4_NUM_SYNC : FT8_NUM_SYNC;
+    const int length_sync = is_ft4 ? FT4_LENGTH_SYNC : FT8_LENGTH_SYNC;
+    const int sync_offset = is_ft4 ? FT4_SYNC_OFFSET : FT8_SYNC_OFFSET;
+    const int last_tone = is_ft4 ? 3 : 7;
+    const int view_first = get_view_first(wf);
+    sync_vec_t sum[2] = { SYNC_ZERO(), SYNC_ZERO() };
+    int num_average = 0;
+
+    for (int m = 0; m < num_sync; ++m)
+    {
+        for (int k = 0; k < length_sync; ++k)
+        {
+            int block = (is_ft4 ? 1 : 0) + (sync_offset * m) + k;
+            int block_abs = candidate->time_offset + block;
+            // Check for time boundaries
+            if (block_abs < 0)
+                continue;
+            if (block_abs >= wf->num_blocks)
+                break;
+
+            const uint8_t* p = wrap ? get_cand_mag(wf, view_first, candidate, block_abs) : (mag_first + (block_abs - block_first) * block_step);
+            int sm = is_ft4 ? kFT4_Costas_pattern[m][k] : kFT8_Costas_pattern[k];
+            sync_vec_t sym[2];
+            sync_load(p + sm, sym);
+
+            if (sm > 0)
+            {
+                sync_add_diff(sum, sym, p + sm - 1);
+                ++num_average;
+            }
+            if (sm < last_tone)
+            {
+                sync_add_diff(sum, sym, p + sm + 1);
+                ++num_average;
+            }
+            if ((k > 0) && (block_abs > 0))
+            {
+                const uint8_t* p_prev = wrap ? get_cand_mag(wf, view_first, candidate, block_abs - 1) : (p - block_step);
+                sync_add_diff(sum, sym, p_prev + sm);
+                ++num_average;
+            }
+            if (((k + 1) < length_sync) && ((block_abs + 1) < wf->num_blocks))
+            {
+                const uint8_t* p_next = wrap ? get_cand_mag(wf, view_first, candidate, block_abs + 1) : (p + block_step);
+                sync_add_diff(sum, sym, p_next + sm);
+                ++num_average;
+            }
+        }
+    }
+
+    SYNC_STORE(sums, sum[0]);
+    SYNC_STORE(sums + 8, sum[1]);
+    return num_average;
+}
+
+// Dispatch to the variants of sync_score_lanes() specialized for the protocol and the ring buffer wrap-around
+static int sync_score_lanes_any(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate, const uint8_t* mag_first, int block_first, int block_step, bool wrap, int16_t sums[SYNC_LANES])
+{
+    if (wf->protocol == FTX_PROTOCOL_FT4)
+    {
+        if (wrap)
+            return sync_score_lanes(wf, candidate, mag_first, block_first, block_step, true, true, sums);
+        return sync_score_lanes(wf, candidate, mag_first, block_first, block_step, true, false, sums);
+    }
+    if (wrap)
+        return sync_score_lanes(wf, candidate, mag_first, block_first, block_step, false, true, sums);
+    return sync_score_lanes(wf, candidate, mag_first, block_first, block_step, false, false, sums);
+}
+
+// Smallest sum of score terms that gives a score (sum / num_average, rounded toward zero) of at least min_score
+static int sync_min_sum(int min_score, int num_average)
+{
+    if (num_average == 0)
+        return (min_score <= 0) ? INT16_MIN : (INT16_MAX + 1);
+    return (min_score > 0) ? (min_score * num_average) : ((min_score - 1) * num_average + 1);
+}
+
+// Bit mask of the lanes with a sum of at least min_sum
+static uint32_t sync_lanes_pass(const int16_t sums[SYNC_LANES], int min_sum)
+{
+    if (min_sum > INT16_MAX)
+        return 0;
+    if (min_sum <= INT16_MIN)
+        return (1u << SYNC_LANES) - 1;
+#if defined(__SSE2__)
+    const __m128i threshold = _mm_set1_epi16((int16_t)(min_sum - 1));
+    __m128i pass_lo = _mm_cmpgt_epi16(_mm_loadu_si128((const __m128i*)sums), threshold);
+    __m128i pass_hi = _mm_cmpgt_epi16(_mm_loadu_si128((const __m128i*)(sums + 8)), threshold);
+    return (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(pass_lo, pass_hi));
+#else
+    uint32_t pass = 0;
+    for (int lane = 0; lane < SYNC_LANES; ++lane)
+    {
+        if (sums[lane] >= min_sum)
+            pass |= (1u << lane);
+    }
+    return pass;
+#endif
+}
+
+// Mask of the first num_lanes lanes
+static inline uint32_t sync_lanes_first(int num_lanes)
+{
+    return (num_lanes < SYNC_LANES) ? ((1u << num_lanes) - 1) : ((1u << SYNC_LANES) - 1);
+}
+
+// Add the lanes in lane_mask passing the threshold (in frequency order) to the heap
+// @return New size of the heap
+static int heap_add_lanes(ftx_candidate_t heap[], int heap_size, int num_candidates, const ftx_candidate_t* first,
+    const int16_t sums[SYNC_LANES], uint32_t lane_mask, int num_average, int min_sum, candidate_log_t* log)
+{
+    uint32_t pass = sync_lanes_pass(sums, min_sum) & lane_mask;
+    for (int lane = 0; pass != 0; ++lane, pass >>= 1)
+    {
+        if ((pass & 1) == 0)
+            continue;
+        ftx_candidate_t lane_candidate = *first;
+        lane_candidate.freq_offset += lane;
+        lane_candidate.score = (num_average > 0) ? (sums[lane] / num_average) : 0;
+        heap_size = heap_add_logged(heap, heap_size, num_candidates, &lane_candidate, log);
+    }
+    return heap_size;
+}
+
+// Sums of the sync terms of the SYNC_LANES candidates starting at candidate->freq_offset (a multiple of SYNC_LANES)
+// @return Number of terms of each sum, or -1 for the last few frequency offsets of a uint8_t waterfall,
+// where vector loads would read past the row
+static int sync_score_lanes_at(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate, uint8_t* tile, int16_t sums[SYNC_LANES])
+{
+    const int num_tones = (wf->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+    if (wf->format == FTX_WATERFALL_FORMAT_U4)
+    {
+        // Tiles are padded, so the lanes past the last frequency offset only need to be masked out
+        u4_fill_tile(wf, candidate, tile);
+        return sync_score_lanes_any(wf, candidate, tile + u4_tile_column(candidate), candidate->time_offset - 1, U4_TILE_WIDTH, false, sums);
+    }
+    // The loads of the highest tone of the last lane reach num_tones bins past it
+    if (candidate->freq_offset + SYNC_LANES + num_tones > wf->num_bins)
+        return -1;
+    const int view_first = get_view_first(wf);
+    const bool wrap = (view_first + wf->num_blocks > wf->max_blocks);
+    const uint8_t* mag_first = wrap ? NULL : get_cand_mag(wf, view_first, candidate, 0);
+    return sync_score_lanes_any(wf, candidate, mag_first, 0, ftx_waterfall_block_step(wf), wrap, sums);
+}
+
+/// Score the candidates of one time offset (and time/frequency subdivision) SYNC_LANES frequency offsets at a time,
+/// starting at candidate->freq_offset, and add those that pass min_score to the heap (in the order of frequency offsets).
+/// Stops before the last few frequency offsets of a uint8_t waterfall, where vector loads would read past the row,
+/// leaving candidate->freq_offset at the first offset not scored. Returns the new heap size.
+static int find_candidates_lanes(const ftx_waterfall_t* wf, ftx_candidate_t* candidate, int num_candidates, ftx_candidate_t heap[], int heap_size, int min_score,
+    uint8_t* tile, candidate_log_t* log)
+{
+    const int num_tones = (wf->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+    const int num_offsets = wf->num_bins - num_tones + 1;
+    int16_t sums[SYNC_LANES];
+
+    while (candidate->freq_offset < num_offsets)
+    {
+        int num_average = sync_score_lanes_at(wf, candidate, tile, sums);
+        if (num_average < 0)
+            break;
+        uint32_t lane_mask = sync_lanes_first(num_offsets - candidate->freq_offset);
+        heap_size = heap_add_lanes(heap, heap_size, num_candidates, candidate, sums, lane_mask, num_average, sync_min_sum(min_score, num_average), log);
+        candidate->freq_offset += SYNC_LANES;
+    }
+    return heap_size;
+}
+#endif
+
+// Number of time offsets searched for candidates (-10 .. 19)
+#define SEARCH_NUM_OFFSETS 30
+
+// Search the candidates of rows row_begin .. row_end - 1, where a row is one of num_time_offsets time offsets
+// (from time_offset_min) of a time and frequency subdivision, in the order of the loops of ftx_find_candidates().
+// Candidates passing min_score are added to the heap.
+// @return New size of the heap
+static int find_candidates_rows(const ftx_waterfall_t* wf, int time_offset_min, int num_time_offsets, int row_begin, int row_end, int num_candidates,
+    ftx_candidate_t heap[], int heap_size, int min_score, candidate_log_t* log)
+{
+    int (*sync_fun)(const ftx_waterfall_t*, const ftx_candidate_t*) = (wf->protocol == FTX_PROTOCOL_FT4) ? ft4_sync_score : ft8_sync_score;
+    int num_tones = (wf->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+
+    ftx_candidate_t candidate;
+#ifndef WATERFALL_USE_PHASE
+    // Compact waterfalls are unpacked tile by tile, right before scoring the candidates in the tile
+    int (*sync_tile_fun)(const ftx_waterfall_t*, const ftx_candidate_t*, const uint8_t*) = (wf->protocol == FTX_PROTOCOL_FT4) ? ft4_sync_score_tile : ft8_sync_score_tile;
+    const bool compact = (wf->format == FTX_WATERFALL_FORMAT_U4);
+    uint8_t tile[U4_TILE_ROWS * U4_TILE_WIDTH];
+#endif
+
+    // Here we allow time offsets that exceed signal boundaries, as long as we still have all data bits.
+    // I.e. we can afford to skip the first 7 or the last 7 Costas symbols, as long as we track how many
+    // sync symbols we included in the score, so the score is averaged.
+    for (int row = row_begin; row < row_end; ++row)
+    {
+        int sub = row / num_time_offsets;
+        candidate.time_sub = sub / wf->freq_osr;
+        candidate.freq_sub = sub % wf->freq_osr;
+        candidate.time_offset = time_offset_min + (row % num_time_offsets);
+        candidate.freq_offset = 0;
+#ifdef SYNC_SIMD
+        heap_size = find_candidates_lanes(wf, &candidate, num_candidates, heap, heap_size, min_score, tile, log);
+#endif
+        // Score the remaining frequency offsets one by one
+        for (; (candidate.freq_offset + num_tones - 1) < wf->num_bins; ++candidate.freq_offset)
+        {
+#ifndef WATERFALL_USE_PHASE
+            if (compact)
+            {
+                if ((candidate.freq_offset % U4_TILE_BINS) == 0)
+                    u4_fill_tile(wf, &candidate, tile);
+                candidate.score = sync_tile_fun(wf, &candidate, tile);
+            }
+            else
+#endif
+                candidate.score = sync_fun(wf, &candidate);
+
+            if (candidate.score < min_score)
+                continue;
+
+            heap_size = heap_add_logged(heap, heap_size, num_candidates, &candidate, log);
+        }
+    }
+    return heap_size;
+}
+
+int ftx_find_candidates(const ftx_waterfall_t* wf, int num_candidates, ftx_candidate_t heap[], int min_score)
+{
+    int num_rows = wf->time_osr * wf->freq_osr * SEARCH_NUM_OFFSETS;
+    int heap_size = find_candidates_rows(wf, -10, SEARCH_NUM_OFFSETS, 0, num_rows, num_candidates, heap, 0, min_score, NULL);
+    heap_sort(heap, heap_size);
+    return heap_size;
+}
+
+#ifndef WATERFALL_USE_PHASE
+// Sync scores are averages of magnitude differences, in -255 .. 255
+#define BUCKET_SCORE_MIN (-255)
+#define BUCKET_NUM_SCORES 511
+// Score of the positions below min_score in the score rows of ftx_find_candidates_bucketed()
+#define BUCKET_NONE INT16_MIN
+
+// Scores of the num_offsets frequency offsets of one row (time offset and subdivisions of candidate),
+// or BUCKET_NONE if below min_score. The scores from min_score up are counted in count[score - BUCKET_SCORE_MIN].
+static void bucket_score_row(const ftx_waterfall_t* wf, ftx_candidate_t* candidate, int num_offsets, int min_score, int16_t scores[], int count[], uint8_t* tile)
+{
+    const bool compact = (wf->format == FTX_WATERFALL_FORMAT_U4);
+    candidate->freq_offset = 0;
+#ifdef SYNC_SIMD
+    int16_t sums[SYNC_LANES];
+    while (candidate->freq_offset < num_offsets)
+    {
+        int num_average = sync_score_lanes_at(wf, candidate, tile, sums);
+        if (num_average < 0)
+            break;
+        uint32_t pass = sync_lanes_pass(sums, sync_min_sum(min_score, num_average));
+        int num_lanes = num_offsets - candidate->freq_offset;
+        if (num_lanes > SYNC_LANES)
+            num_lanes = SYNC_LANES;
+        int16_t* lane_scores = scores + candidate->freq_offset;
+        for (int lane = 0; lane < num_lanes; ++lane)
+        {
+            lane_scores[lane] = BUCKET_NONE;
+        }
+        for (int lane = 0; pass != 0; ++lane, pass >>= 1)
+        {
+            if (((pass & 1) == 0) || (lane >= num_lanes))
+                continue;
+            lane_scores[lane] = (num_average > 0) ? (sums[lane] / num_average) : 0;
+            ++count[lane_scores[lane] - BUCKET_SCORE_MIN];
+        }
+        candidate->freq_offset += SYNC_LANES;
+    }
+#endif
+    // Score the remaining frequency offsets one by one
+    for (; candidate->freq_offset < num_offsets; ++candidate->freq_offset)
+    {
+        int score;
+        if (compact)
+        {
+            if ((candidate->freq_offset % U4_TILE_BINS) == 0)
+                u4_fill_tile(wf, candidate, tile);
+            score = (wf->protocol == FTX_PROTOCOL_FT4) ? ft4_sync_score_tile(wf, candidate, tile) : ft8_sync_score_tile(wf, candidate, tile);
+        }
+        else
+            score = (wf->protocol == FTX_PROTOCOL_FT4) ? ft4_sync_score(wf, candidate) : ft8_sync_score(wf, candidate);
+        if (score < min_score)
+        {
+            scores[candidate->freq_offset] = BUCKET_NONE;
+            continue;
+        }
+        scores[candidate->freq_offset] = score;
+        ++count[score - BUCKET_SCORE_MIN];
+    }
+}
+
+size_t ftx_find_candidates_bucketed_size(const ftx_waterfall_t* wf)
+{
+    const int num_tones = (wf->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+    const int num_offsets = wf->num_bins - num_tones + 1;
+    const int num_rows = wf->time_osr * wf->freq_osr * SEARCH_NUM_OFFSETS;
+    if (num_offsets <= 0)
+        return 0;
+
+    // Rows of scores padded to whole vectors
+    const int row_stride = (num_offsets + 15) & ~15;
+    return num_rows * row_stride * sizeof(int16_t);
+}
+
+int ftx_find_candidates_bucketed(const ftx_waterfall_t* wf, void* mem, int num_candidates, ftx_candidate_t candidates[], int min_score)
+{
+    const int num_tones = (wf->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+    const int num_offsets = wf->num_bins - num_tones + 1;
+    const int num_rows = wf->time_osr * wf->freq_osr * SEARCH_NUM_OFFSETS;
+    if ((num_offsets <= 0) || (num_candidates <= 0))
+        return 0;
+    if (min_score < BUCKET_SCORE_MIN)
+        min_score = BUCKET_SCORE_MIN;
+    if (min_score >= BUCKET_SCORE_MIN + BUCKET_NUM_SCORES)
+        return 0;
+
+    // Rows are padded to whole vectors of scores, with positions below min_score
+    const int row_stride = (num_offsets + 15) & ~15;
+    int16_t* scores = (int16_t*)mem;
+
+    // Score all positions and count them by score
+    int count[BUCKET_NUM_SCORES] = { 0 };
+    uint8_t tile[U4_TILE_ROWS * U4_TILE_WIDTH];
+    ftx_candidate_t candidate;
+    for (int row = 0; row < num_rows; ++row)
+    {
+        int sub = row / SEARCH_NUM_OFFSETS;
+        candidate.time_sub = sub / wf->freq_osr;
+        candidate.freq_sub = sub % wf->freq_osr;
+        candidate.time_offset = -10 + (row % SEARCH_NUM_OFFSETS);
+        int16_t* row_scores = scores + row * row_stride;
+        bucket_score_row(wf, &candidate, num_offsets, min_score, row_scores, count, tile);
+        for (int freq_offset = num_offsets; freq_offset < row_stride; ++freq_offset)
+        {
+            row_scores[freq_offset] = BUCKET_NONE;
+        }
+    }
+
+    // Lowest score selected (threshold), and the first output position of every score from the threshold up
+    int first[BUCKET_NUM_SCORES];
+    int num_selected = 0;
+    int threshold = BUCKET_NUM_SCORES - 1;
+    for (; threshold >= min_score - BUCKET_SCORE_MIN; --threshold)
+    {
+        first[threshold] = num_selected;
+        num_selected += count[threshold];
+        if (num_selected >= num_candidates)
+            break;
+    }
+    if (threshold < min_score - BUCKET_SCORE_MIN)
+        threshold = min_score - BUCKET_SCORE_MIN;
+    if (num_selected > num_candidates)
+        num_selected = num_candidates;
+
+    // Place the positions at or above the threshold in the order of the search (counting sort), skipping
+    // whole vectors below it. Only the first of the positions at the threshold score fit.
+    const int min_sum = threshold + BUCKET_SCORE_MIN;
+    for (int row = 0; row < num_rows; ++row)
+    {
+        const int16_t* row_scores = scores + row * row_stride;
+        int sub = row / SEARCH_NUM_OFFSETS;
+        candidate.time_sub = sub / wf->freq_osr;
+        candidate.freq_sub = sub % wf->freq_osr;
+        candidate.time_offset = -10 + (row % SEARCH_NUM_OFFSETS);
+        for (int group = 0; group < row_stride; group += 16)
+        {
+#ifdef SYNC_SIMD
+            uint32_t pass = sync_lanes_pass(row_scores + group, min_sum);
+#else
+            uint32_t pass = 0xFFFF;
+#endif
+            for (int lane = 0; pass != 0; ++lane, pass >>= 1)
+            {
+                int score = row_scores[group + lane];
+                if (((pass & 1) == 0) || (score < min_sum))
+                    continue;
+                int* position = &first[score - BUCKET_SCORE_MIN];
+                if (*position >= num_selected)
+                    continue;
+                candidate.freq_offset = group + lane;
+                candidate.score = score;
+                candidates[(*position)++] = candidate;
+            }
+        }
+    }
+    return num_selected;
+}
+#endif
+
+// Sync score of a single candidate, in any waterfall format
+static int sync_score_any(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate)
+{
+#ifndef WATERFALL_USE_PHASE
+    if (wf->format == FTX_WATERFALL_FORMAT_U4)
+    {
+        // Tiles start at a multiple of U4_TILE_BINS
+        uint8_t tile[U4_TILE_ROWS * U4_TILE_WIDTH];
+        ftx_candidate_t tile_first = *candidate;
+        tile_first.freq_offset -= candidate->freq_offset % U4_TILE_BINS;
+        u4_fill_tile(wf, &tile_first, tile);
+        return (wf->protocol == FTX_PROTOCOL_FT4) ? ft4_sync_score_tile(wf, candidate, tile) : ft8_sync_score_tile(wf, candidate, tile);
+    }
+#endif
+    return (wf->protocol == FTX_PROTOCOL_FT4) ? ft4_sync_score(wf, candidate) : ft8_sync_score(wf, candidate);
+}
+
+// Positions to score in a group of 16 frequency offsets (from 16 * group) of a row, as a bit mask
+typedef uint32_t (*lane_mask_t)(const void* ctx, int row, int group);
+
+// Score the positions given by lane_mask (rows as in find_candidates_rows()) in rows row_begin .. row_end - 1,
+// and add those passing min_score to the heap. Returns the new size of the heap.
+static int find_candidates_marked(const ftx_waterfall_t* wf, lane_mask_t lane_mask_of, const void* ctx, int time_offset_min, int num_time_offsets,
+    int row_begin, int row_end, int num_candidates, ftx_candidate_t heap[], int heap_size, int min_score)
+{
+    const int num_tones = (wf->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+    const int num_offsets = wf->num_bins - num_tones + 1;
+    const int num_groups = (num_offsets + 15) / 16;
+    ftx_candidate_t candidate;
+#ifdef SYNC_SIMD
+    uint8_t tile[U4_TILE_ROWS * U4_TILE_WIDTH];
+    int16_t sums[SYNC_LANES];
+#endif
+    for (int row = row_begin; row < row_end; ++row)
+    {
+        int sub = row / num_time_offsets;
+        candidate.time_sub = sub / wf->freq_osr;
+        candidate.freq_sub = sub % wf->freq_osr;
+        candidate.time_offset = time_offset_min + (row % num_time_offsets);
+        for (int group = 0; group < num_groups; ++group)
+        {
+            uint32_t lane_mask = lane_mask_of(ctx, row, group);
+            if (lane_mask == 0)
+                continue;
+            candidate.freq_offset = group * 16;
+#ifdef SYNC_SIMD
+            int num_average = sync_score_lanes_at(wf, &candidate, tile, sums);
+            if (num_average >= 0)
+            {
+                heap_size = heap_add_lanes(heap, heap_size, num_candidates, &candidate, sums, lane_mask, num_average, sync_min_sum(min_score, num_average), NULL);
+                continue;
+            }
+#endif
+            for (int lane = 0; lane_mask != 0; ++lane, lane_mask >>= 1)
+            {
+                if ((lane_mask & 1) == 0)
+                    continue;
+                ftx_candidate_t lane_candidate = candidate;
+                lane_candidate.freq_offset += lane;
+                lane_candidate.score = sync_score_any(wf, &lane_candidate);
+                if (lane_candidate.score < min_score)
+                    continue;
+                heap_size = heap_add(heap, heap_size, num_candidates, &lane_candidate);
+            }
+        }
+    }
+    return heap_size;
+}
+
+typedef struct
+{
+    const uint16_t* needed; ///< Bit mask of 16 frequency offsets for each group of each row
+    int num_groups;         ///< Groups per row
+} marks_t;
+
+static uint32_t marks_lane_mask(const void* ctx, int row, int group)
+{
+    const marks_t* marks = (const marks_t*)ctx;
+    return marks->needed[(row * marks->num_groups) + group];
+}
+
+size_t ftx_find_candidates_coarse_size(const ftx_waterfall_t* wf, const ftx_search_params_t* params)
+{
+    const int num_tones = (wf->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+    const int num_offsets = wf->num_bins - num_tones + 1;
+    const int num_time_offsets = params->time_offset_max - params->time_offset_min + 1;
+    if ((num_time_offsets <= 0) || (num_offsets <= 0) || (params->num_coarse <= 0))
+        return 0;
+
+    // Coarse positions, then the marks of the fine pass
+    const int num_groups = (num_offsets + 15) / 16;
+    const int num_rows = wf->time_osr * wf->freq_osr * num_time_offsets;
+    return (params->num_coarse * sizeof(ftx_candidate_t)) + (num_rows * num_groups * sizeof(uint16_t));
+}
+
+int ftx_find_candidates_coarse(const ftx_waterfall_t* wf, const ftx_search_params_t* params, void* mem, int num_candidates, ftx_candidate_t heap[], int min_score)
+{
+    const int num_tones = (wf->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+    const int num_offsets = wf->num_bins - num_tones + 1;
+    const int num_time_offsets = params->time_offset_max - params->time_offset_min + 1;
+    if ((num_time_offsets <= 0) || (num_offsets <= 0) || (params->num_coarse <= 0))
+        return 0;
+
+    // Coarse pass: only the first time and frequency subdivision, i.e. the waterfall without oversampling
+    ftx_candidate_t* coarse = (ftx_candidate_t*)mem;
+    int num_coarse = find_candidates_rows(wf, params->time_offset_min, num_time_offsets, 0, num_time_offsets, params->num_coarse, coarse, 0,
+        min_score - params->coarse_margin, NULL);
+    heap_sort(coarse, num_coarse);
+
+    // Coarse positions are scored already, with a lower threshold
+    int heap_size = 0;
+    for (int idx = 0; idx < num_coarse; ++idx)
+    {
+        if (coarse[idx].score >= min_score)
+            heap_size = heap_add(heap, heap_size, num_candidates, &coarse[idx]);
+    }
+
+    // Fine pass: the other subdivisions within one symbol period and one tone spacing around the coarse positions.
+    // The positions to score are marked in groups of 16 frequency offsets for each row (time offset of a subdivision).
+    const int num_groups = (num_offsets + 15) / 16;
+    const int num_rows = wf->time_osr * wf->freq_osr * num_time_offsets;
+    uint16_t* needed = (uint16_t*)(coarse + params->num_coarse);
+    for (int idx = 0; idx < num_rows * num_groups; ++idx)
+    {
+        needed[idx] = 0;
+    }
+    for (int idx = 0; idx < num_coarse; ++idx)
+    {
+        for (int time_step = 1 - wf->time_osr; time_step < wf->time_osr; ++time_step)
+        {
+            for (int freq_step = 1 - wf->freq_osr; freq_step < wf->freq_osr; ++freq_step)
+            {
+                // Subdivisions below the coarse position belong to the previous time offset (frequency bin)
+                int time_shift = (time_step < 0) ? -1 : 0;
+                int freq_shift = (freq_step < 0) ? -1 : 0;
+                int time_offset = coarse[idx].time_offset + time_shift;
+                int freq_offset = coarse[idx].freq_offset + freq_shift;
+                if ((time_offset < params->time_offset_min) || (time_offset > params->time_offset_max))
+                    continue;
+                if ((freq_offset < 0) || (freq_offset >= num_offsets))
+                    continue;
+                int sub = ((time_step - (time_shift * wf->time_osr)) * wf->freq_osr) + (freq_step - (freq_shift * wf->freq_osr));
+                if (sub == 0)
+                    continue;
+                int row = (sub * num_time_offsets) + (time_offset - params->time_offset_min);
+                needed[(row * num_groups) + (freq_offset / 16)] |= (1 << (freq_offset % 16));
+            }
+        }
+    }
+
+    // Score the marked positions in the order of ftx_find_candidates()
+    const marks_t marks = { .needed = needed, .num_groups = num_groups };
+    heap_size = find_candidates_marked(wf, marks_lane_mask, &marks, params->time_offset_min, num_time_offsets, num_time_offsets, num_rows, num_candidates, heap,
+        heap_size, min_score);
+
+    heap_sort(heap, heap_size);
+    return heap_size;
+}
+
+typedef struct
+{
+    const ftx_search_window_t* windows;
+    int num_windows;
+    int num_offsets; ///< Frequency offsets of the search
+} windows_t;
+
+// Positions of a group covered by any of the windows (once, even where windows overlap), clamped to the search
+static uint32_t windows_lane_mask(const void* ctx, int row, int group)
+{
+    const windows_t* search = (const windows_t*)ctx;
+    const int time_offset = -10 + (row % SEARCH_NUM_OFFSETS);
+    const int group_min = group * 16;
+    const int group_max = (group_min + 15 < search->num_offsets - 1) ? (group_min + 15) : (search->num_offsets - 1);
+    uint32_t lane_mask = 0;
+    for (int idx = 0; idx < search->num_windows; ++idx)
+    {
+        const ftx_search_window_t* window = &search->windows[idx];
+        if ((time_offset < window->time_offset_min) || (time_offset > window->time_offset_max))
+            continue;
+        int freq_offset_min = (window->freq_offset_min > group_min) ? window->freq_offset_min : group_min;
+        int freq_offset_max = (window->freq_offset_max < group_max) ? window->freq_offset_max : group_max;
+        if (freq_offset_min > freq_offset_max)
+            continue;
+        // Lanes freq_offset_min .. freq_offset_max of the group
+        lane_mask |= ((2u << (freq_offset_max - group_min)) - 1) & ~((1u << (freq_offset_min - group_min)) - 1);
+    }
+    return lane_mask;
+}
+
+int ftx_find_candidates_windows(const ftx_waterfall_t* wf, const ftx_search_window_t windows[], int num_windows, int num_candidates, ftx_candidate_t heap[], int min_score)
+{
+    const int num_tones = (wf->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+    const int num_offsets = wf->num_bins - num_tones + 1;
+    if (num_offsets <= 0)
+        return 0;
+
+    // A DT window over all frequency offsets is searched row by row, as in ftx_find_candidates()
+    if ((num_windows == 1) && (windows[0].freq_offset_min <= 0) && (windows[0].freq_offset_max >= num_offsets - 1))
+    {
+        int time_offset_min = (windows[0].time_offset_min > -10) ? windows[0].time_offset_min : -10;
+        int time_offset_max = (windows[0].time_offset_max < SEARCH_NUM_OFFSETS - 11) ? windows[0].time_offset_max : (SEARCH_NUM_OFFSETS - 11);
+        int num_time_offsets = time_offset_max - time_offset_min + 1;
+        if (num_time_offsets <= 0)
+            return 0;
+        int num_rows = wf->time_osr * wf->freq_osr * num_time_offsets;
+        int heap_size = find_candidates_rows(wf, time_offset_min, num_time_offsets, 0, num_rows, num_candidates, heap, 0, min_score, NULL);
+        heap_sort(heap, heap_size);
+        return heap_size;
+    }
+
+    // The positions of the windows are found for each group of 16 frequency offsets while searching
+    const windows_t search = { .windows = windows, .num_windows = num_windows, .num_offsets = num_offsets };
+    const int num_rows = wf->time_osr * wf->freq_osr * SEARCH_NUM_OFFSETS;
+    int heap_size = find_candidates_marked(wf, windows_lane_mask, &search, -10, SEARCH_NUM_OFFSETS, 0, num_rows, num_candidates, heap, 0, min_score);
+    heap_sort(heap, heap_size);
+    return heap_size;
+}
+
+#ifdef FTX_USE_THREADS
+// Entries logged per shard, beyond the heap size (insertions after the heap of a shard is full)
+#define SHARD_LOG_EXTRA 2048
+
+typedef struct
+{
+    const ftx_waterfall_t* wf;
+    int row_begin;
+    int row_end;
+    int num_candidates;
+    int min_score;
+    ftx_candidate_t* heap; ///< Heap of the shard (num_candidates entries)
+    candidate_log_t log;   ///< Candidates that entered the heap of the shard
+} find_shard_t;
+
+static void* find_shard_run(void* arg)
+{
+    find_shard_t* shard = (find_shard_t*)arg;
+    find_candidates_rows(shard->wf, -10, SEARCH_NUM_OFFSETS, shard->row_begin, shard->row_end, shard->num_candidates, shard->heap, 0, shard->min_score, &shard->log);
+    return NULL;
+}
+#endif
+
+size_t ftx_find_candidates_parallel_size(int num_threads, int num_candidates)
+{
+#ifdef FTX_USE_THREADS
+    if (num_threads > FTX_MAX_THREADS)
+        num_threads = FTX_MAX_THREADS;
+    if ((num_threads < 2) || (num_candidates <= 0))
+        return 0;
+    // Heap of each shard, followed by its log
+    return num_threads * (num_candidates + num_candidates + SHARD_LOG_EXTRA) * sizeof(ftx_candidate_t);
+#else
+    (void)num_threads;
+    (void)num_candidates;
+    return 0;
+#endif
+}
+
+int ftx_find_candidates_parallel(const ftx_waterfall_t* wf, int num_threads, void* mem, int num_candidates, ftx_candidate_t heap[], int min_score)
+{
+#ifdef FTX_USE_THREADS
+    int num_rows = wf->time_osr * wf->freq_osr * SEARCH_NUM_OFFSETS;
+    if (num_threads > num_rows)
+        num_threads = num_rows;
+    if (num_threads > FTX_MAX_THREADS)
+        num_threads = FTX_MAX_THREADS;
+    if (num_threads < 2)
+        return ftx_find_candidates(wf, num_candidates, heap, min_score);
+
+    // Each shard is a contiguous range of rows, so the shards in turn follow the order of the serial search
+    const int log_capacity = num_candidates + SHARD_LOG_EXTRA;
+    ftx_candidate_t* shard_mem = (ftx_candidate_t*)mem;
+    find_shard_t shards[FTX_MAX_THREADS];
+    pthread_t threads[FTX_MAX_THREADS];
+    bool started[FTX_MAX_THREADS];
+    for (int idx = 0; idx < num_threads; ++idx)
+    {
+        find_shard_t* shard = &shards[idx];
+        shard->wf = wf;
+        shard->row_begin = (idx * num_rows) / num_threads;
+        shard->row_end = ((idx + 1) * num_rows) / num_threads;
+        shard->num_candidates = num_candidates;
+        shard->min_score = min_score;
+        shard->heap = shard_mem + (idx * (num_candidates + log_capacity));
+        shard->log.items = shard->heap + num_candidates;
+        shard->log.capacity = log_capacity;
+        shard->log.size = 0;
+    }
+    // The calling thread searches the first shard
+    for (int idx = 1; idx < num_threads; ++idx)
+    {
+        started[idx] = (pthread_create(&threads[idx], NULL, find_shard_run, &shards[idx]) == 0);
+    }
+    find_shard_run(&shards[0]);
+
+    // A candidate that did not enter the heap of its shard cannot enter the heap of the serial search either,
+    // whose heap has seen a superset of the earlier candidates. Replaying the logged insertions in order gives
+    // exactly the same heap as the serial search.
+    int heap_size = 0;
+    for (int idx = 0; idx < num_threads; ++idx)
+    {
+        find_shard_t* shard = &shards[idx];
+        if (idx > 0)
+        {
+            if (started[idx])
+                pthread_join(threads[idx], NULL);
+            else
+                find_shard_run(shard);
+        }
+        if (shard->log.size <= shard->log.capacity)
+        {
+            for (int pos = 0; pos < shard->log.size; ++pos)
+            {
+                heap_size = heap_add(heap, heap_size, num_candidates, &shard->log.items[pos]);
+            }
+        }
+        else
+        {
+            // The log overflowed, search the shard again
+            heap_size = find_candidates_rows(wf, -10, SEARCH_NUM_OFFSETS, shard->row_begin, shard->row_end, num_candidates, heap, heap_size, min_score, NULL);
+        }
+    }
+
+    heap_sort(heap, heap_size);
+    return heap_size;
+#else
+    (void)num_threads;
+    (void)mem;
+    return ftx_find_candidates(wf, num_candidates, heap, min_score);
+#endif
+}
+
+// Sort the candidates by sync strength - here we benefit from the heap structure
+static void heap_sort(ftx_candidate_t heap[], int heap_size)
+{
+    int len_unsorted = heap_size;
+    while (len_unsorted > 1)
+    {
+        // Take the top (index 0) element which is guaranteed to have the smallest score,
+        // exchange it with the last element in the heap, and decrease the heap size.
+        // Then restore the heap property in the new, smaller heap.
+        // At the end the elements will be sorted in descending order.
+        ftx_candidate_t tmp = heap[len_unsorted - 1];
+        heap[len_unsorted - 1] = heap[0];
+        heap[0] = tmp;
+        len_unsorted--;
+        heapify_down(heap, len_unsorted);
+    }
+}
+
+int ftx_prune_candidates(const ftx_waterfall_t* wf, int num_candidates, ftx_candidate_t candidates[], int time_radius, int freq_radius)
+{
+    int num_kept = 0;
+    for (int idx = 0; idx < num_candidates; ++idx)
+    {
+        const ftx_candidate_t* cand = &candidates[idx];
+        // Position in time and frequency subdivisions
+        int t = (cand->time_offset * wf->time_osr) + cand->time_sub;
+        int f = (cand->freq_offset * wf->freq_osr) + cand->freq_sub;
+
+        // Candidates are sorted by descending score, so a kept neighbor has at least the same score
+        bool is_maximum = true;
+        for (int idx_kept = 0; idx_kept < num_kept; ++idx_kept)
+        {
+            const ftx_candidate_t* kept = &candidates[idx_kept];
+            int dt = t - ((kept->time_offset * wf->time_osr) + kept->time_sub);
+            int df = f - ((kept->freq_offset * wf->freq_osr) + kept->freq_sub);
+            if ((abs(dt) <= time_radius) && (abs(df) <= freq_radius))
+            {
+                is_maximum = false;
+                break;
+            }
+        }
+        if (is_maximum)
+        {
+            candidates[num_kept++] = *cand;
+        }
+    }
+    return num_kept;
+}
+
+#ifndef WATERFALL_USE_PHASE
+// Neighbor combinations of a sync symbol: frequency neighbors (both, higher only, lower only) x
+// time neighbors (both, next only, previous only)
+#define PLANE_NEIGHBORS_BOTH 0
+#define PLANE_NEIGHBORS_HIGHER_OR_NEXT 1
+#define PLANE_NEIGHBORS_LOWER_OR_PREV 2
+// Zero padding after each row of the planes, so that vector loads of the last frequency offsets stay in the row
+#define PLANE_ROW_PADDING 16
+
+static int planes_row_stride(int num_bins)
+{
+    return ((num_bins + 15) & ~15) + PLANE_ROW_PADDING;
+}
+
+static inline const int16_t* planes_row(const ftx_sync_planes_t* me, int plane, int time_sub, int freq_sub, int block)
+{
+    int row = (plane * me->time_osr) + time_sub;
+    row = (row * me->freq_osr) + freq_sub;
+    row = (row * me->num_blocks) + block;
+    return me->diff + (row * me->row_stride);
+}
+
+size_t ftx_sync_planes_size(const ftx_waterfall_t* wf)
+{
+    // FT4 uses all 9 combinations of neighbors, FT8 only 4
+    int num_planes = (wf->protocol == FTX_PROTOCOL_FT4) ? 9 : 4;
+    return (size_t)num_planes * wf->time_osr * wf->freq_osr * wf->max_blocks * planes_row_stride(wf->num_bins) * sizeof(int16_t);
+}
+
+// Copy (or unpack) the magnitudes of a row of the block with absolute index block_abs,
+// out needs num_bins + U4_TILE_WIDTH entries
+static void load_block_row(const ftx_waterfall_t* wf, int block_abs, int time_sub, int freq_sub, uint8_t* out)
 {
-    int offset = candidate->time_offset;
-    offset = (offset * wf->time_osr) + candidate->time_sub;
-    offset = (offset * wf->freq_osr) + candidate->freq_sub;
-    offset = (offset * wf->num_bins) + candidate->freq_offset;
-    return wf->mag + offset;
+    const uint8_t* row = ftx_waterfall_row(wf, block_abs % wf->max_blocks, time_sub, freq_sub);
+    if (wf->format == FTX_WATERFALL_FORMAT_U4)
+    {
+        for (int bin = 0; bin < wf->num_bins; bin += U4_TILE_WIDTH)
+        {
+            u4_unpack(row, bin, out + bin);
+        }
+    }
+    else
+    {
+        for (int bin = 0; bin < wf->num_bins; ++bin)
+        {
+            out[bin] = row[bin];
+        }
+    }
 }
 
-static int ft8_sync_score(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate)
+// Assign a plane to every combination of neighbors used by the sync pattern (in order of first use)
+// @return Number of planes
+static int planes_assign(ftx_protocol_t protocol, uint8_t plane_of[FT4_NUM_SYNC][FT8_LENGTH_SYNC], uint8_t plane_freq[9], uint8_t plane_time[9])
 {
-    int score = 0;
-    int num_average = 0;
+    const bool is_ft4 = (protocol == FTX_PROTOCOL_FT4);
+    const int num_sync = is_ft4 ? FT4_NUM_SYNC : FT8_NUM_SYNC;
+    const int length_sync = is_ft4 ? FT4_LENGTH_SYNC : FT8_LENGTH_SYNC;
+    const int last_tone = is_ft4 ? 3 : 7;
 
-    // Get the pointer to symbol 0 of the candidate
-    const WF_ELEM_T* mag_cand = get_cand_mag(wf, candidate);
-
-    // Compute average score over sync symbols (m+k = 0-7, 36-43, 72-79)
-    for (int m = 0; m < FT8_NUM_SYNC; ++m)
+    int plane_of_combination[9];
+    for (int idx = 0; idx < 9; ++idx)
     {
-        for (int k = 0; k < FT8_LENGTH_SYNC; ++k)
+        plane_of_combination[idx] = -1;
+    }
+    int num_planes = 0;
+    for (int m = 0; m < num_sync; ++m)
+    {
+        for (int k = 0; k < length_sync; ++k)
         {
-            int block = (FT8_SYNC_OFFSET * m) + k;          // relative to the message
-            int block_abs = candidate->time_offset + block; // relative to the captured signal
-            // Check for time boundaries
-            if (block_abs < 0)
-                continue;
-            if (block_abs >= wf->num_blocks)
-                break;
+            int sm = is_ft4 ? kFT4_Costas_pattern[m][k] : kFT8_Costas_pattern[k];
+            int freq = (sm == 0) ? PLANE_NEIGHBORS_HIGHER_OR_NEXT : ((sm == last_tone) ? PLANE_NEIGHBORS_LOWER_OR_PREV : PLANE_NEIGHBORS_BOTH);
+            int time = (k == 0) ? PLANE_NEIGHBORS_HIGHER_OR_NEXT : ((k + 1 == length_sync) ? PLANE_NEIGHBORS_LOWER_OR_PREV : PLANE_NEIGHBORS_BOTH);
+            int combination = (freq * 3) + time;
+            if (plane_of_combination[combination] < 0)
+            {
+                plane_freq[num_planes] = freq;
+                plane_time[num_planes] = time;
+                plane_of_combination[combination] = num_planes;
+                ++num_planes;
+            }
+            plane_of[m][k] = plane_of_combination[combination];
+        }
+    }
+    return num_planes;
+}
 
-            // Get the pointer to symbol 'block' of the candidate
-            const WF_ELEM_T* p8 = mag_cand + (block * wf->block_stride);
+// Compute the rows of all planes for one block, given the magnitudes of the block and its neighbors.
+// The magnitude rows have a zero bin before and after the num_bins bins. Plane rows are plane_step values apart in out.
+static void planes_fill_rows(int num_planes, const uint8_t* plane_freq, const uint8_t* plane_time, const uint8_t* prev, const uint8_t* cur,
+    const uint8_t* next, bool has_prev, bool has_next, int num_bins, int row_stride, int16_t* out, int plane_step)
+{
+    for (int plane = 0; plane < num_planes; ++plane)
+    {
+        // Weights of the neighbors, the weight of the cell itself is their sum
+        int w_lower = (plane_freq[plane] != PLANE_NEIGHBORS_HIGHER_OR_NEXT) ? 1 : 0;
+        int w_higher = (plane_freq[plane] != PLANE_NEIGHBORS_LOWER_OR_PREV) ? 1 : 0;
+        int w_prev = (has_prev && (plane_time[plane] != PLANE_NEIGHBORS_HIGHER_OR_NEXT)) ? 1 : 0;
+        int w_next = (has_next && (plane_time[plane] != PLANE_NEIGHBORS_LOWER_OR_PREV)) ? 1 : 0;
+        int w_cell = w_lower + w_higher + w_prev + w_next;
+
+        int16_t* row = out + (plane * plane_step);
+        for (int bin = 0; bin < num_bins; ++bin)
+        {
+            row[bin] = (w_cell * cur[bin]) - (w_lower * cur[bin - 1]) - (w_higher * cur[bin + 1]) - (w_prev * prev[bin]) - (w_next * next[bin]);
+        }
+        for (int bin = num_bins; bin < row_stride; ++bin)
+        {
+            row[bin] = 0;
+        }
+    }
+}
 
-            // Weighted difference between the expected and all other symbols
-            // Does not work as well as the alternative score below
-            // score += 8 * p8[kFT8_Costas_pattern[k]] -
-            //          p8[0] - p8[1] - p8[2] - p8[3] -
-            //          p8[4] - p8[5] - p8[6] - p8[7];
-            // ++num_average;
+void ftx_sync_planes_build(ftx_sync_planes_t* me, const ftx_waterfall_t* wf, void* mem)
+{
+    me->protocol = wf->protocol;
+    me->num_blocks = wf->num_blocks;
+    me->num_bins = wf->num_bins;
+    me->time_osr = wf->time_osr;
+    me->freq_osr = wf->freq_osr;
+    me->row_stride = planes_row_stride(wf->num_bins);
+    me->diff = (int16_t*)mem;
+
+    uint8_t plane_freq[9], plane_time[9];
+    me->num_planes = planes_assign(wf->protocol, me->plane_of, plane_freq, plane_time);
+
+    // Magnitudes of the previous, current and next block, with a zero bin on each side
+    uint8_t rows[3][wf->num_bins + U4_TILE_WIDTH + 2];
+    for (int idx = 0; idx < 3; ++idx)
+    {
+        for (int bin = 0; bin < wf->num_bins + U4_TILE_WIDTH + 2; ++bin)
+        {
+            rows[idx][bin] = 0;
+        }
+    }
 
-            // Check only the neighbors of the expected symbol frequency- and time-wise
-            int sm = kFT8_Costas_pattern[k]; // Index of the expected bin
-            if (sm > 0)
-            {
-                // look at one frequency bin lower
-                score += WF_ELEM_MAG_INT(p8[sm]) - WF_ELEM_MAG_INT(p8[sm - 1]);
-                ++num_average;
-            }
-            if (sm < 7)
-            {
-                // look at one frequency bin higher
-                score += WF_ELEM_MAG_INT(p8[sm]) - WF_ELEM_MAG_INT(p8[sm + 1]);
-                ++num_average;
-            }
-            if ((k > 0) && (block_abs > 0))
-            {
-                // look one symbol back in time
-                score += WF_ELEM_MAG_INT(p8[sm]) - WF_ELEM_MAG_INT(p8[sm - wf->block_stride]);
-                ++num_average;
-            }
-            if (((k + 1) < FT8_LENGTH_SYNC) && ((block_abs + 1) < wf->num_blocks))
+    const int plane_step = wf->time_osr * wf->freq_osr * wf->num_blocks * me->row_stride;
+    for (int time_sub = 0; time_sub < wf->time_osr; ++time_sub)
+    {
+        for (int freq_sub = 0; freq_sub < wf->freq_osr; ++freq_sub)
+        {
+            uint8_t* prev = rows[0] + 1;
+            uint8_t* cur = rows[1] + 1;
+            uint8_t* next = rows[2] + 1;
+            if (wf->num_blocks > 0)
+                load_block_row(wf, wf->block_start, time_sub, freq_sub, next);
+            for (int block = 0; block < wf->num_blocks; ++block)
             {
-                // look one symbol forward in time
-                score += WF_ELEM_MAG_INT(p8[sm]) - WF_ELEM_MAG_INT(p8[sm + wf->block_stride]);
-                ++num_average;
+                uint8_t* tmp = prev;
+                prev = cur;
+                cur = next;
+                next = tmp;
+                bool has_next = (block + 1 < wf->num_blocks);
+                if (has_next)
+                    load_block_row(wf, wf->block_start + block + 1, time_sub, freq_sub, next);
+
+                int16_t* out = me->diff + (planes_row(me, 0, time_sub, freq_sub, block) - me->diff);
+                planes_fill_rows(me->num_planes, plane_freq, plane_time, prev, cur, next, block > 0, has_next, wf->num_bins, me->row_stride, out, plane_step);
             }
         }
     }
-
-    if (num_average > 0)
-        score /= num_average;
-
-    return score;
 }
 
-static int ft4_sync_score(const ftx_waterfall_t* wf, const ftx_candidate_t* candidate)
+// Number of terms in the sync score of the candidates at a time offset in a view of num_blocks blocks
+// (the same for all frequency offsets)
+static int sync_num_terms(ftx_protocol_t protocol, int num_blocks, int time_offset)
 {
-    int score = 0;
+    const bool is_ft4 = (protocol == FTX_PROTOCOL_FT4);
+    const int num_sync = is_ft4 ? FT4_NUM_SYNC : FT8_NUM_SYNC;
+    const int length_sync = is_ft4 ? FT4_LENGTH_SYNC : FT8_LENGTH_SYNC;
+    const int sync_offset = is_ft4 ? FT4_SYNC_OFFSET : FT8_SYNC_OFFSET;
+    const int last_tone = is_ft4 ? 3 : 7;
     int num_average = 0;
-
-    // Get the pointer to symbol 0 of the candidate
-    const WF_ELEM_T* mag_cand = get_cand_mag(wf, candidate);
-
-    // Compute average score over sync symbols (block = 1-4, 34-37, 67-70, 100-103)
-    for (int m = 0; m < FT4_NUM_SYNC; ++m)
+    for (int m = 0; m < num_sync; ++m)
     {
-        for (int k = 0; k < FT4_LENGTH_SYNC; ++k)
+        for (int k = 0; k < length_sync; ++k)
         {
-            int block = 1 + (FT4_SYNC_OFFSET * m) + k;
-            int block_abs = candidate->time_offset + block;
-            // Check for time boundaries
+            int block_abs = time_offset + (is_ft4 ? 1 : 0) + (sync_offset * m) + k;
             if (block_abs < 0)
                 continue;
-            if (block_abs >= wf->num_blocks)
+            if (block_abs >= num_blocks)
                 break;
+            int sm = is_ft4 ? kFT4_Costas_pattern[m][k] : kFT8_Costas_pattern[k];
+            num_average += (sm > 0) ? 1 : 0;
+            num_average += (sm < last_tone) ? 1 : 0;
+            num_average += ((k > 0) && (block_abs > 0)) ? 1 : 0;
+            num_average += (((k + 1) < length_sync) && ((block_abs + 1) < num_blocks)) ? 1 : 0;
+        }
+    }
+    return num_average;
+}
 
-            // Get the pointer to symbol 'block' of the candidate
-            const WF_ELEM_T* p4 = mag_cand + (block * wf->block_stride);
+int ftx_sync_planes_score(const ftx_sync_planes_t* me, const ftx_candidate_t* candidate)
+{
+    const bool is_ft4 = (me->protocol == FTX_PROTOCOL_FT4);
+    const int num_sync = is_ft4 ? FT4_NUM_SYNC : FT8_NUM_SYNC;
+    const int length_sync = is_ft4 ? FT4_LENGTH_SYNC : FT8_LENGTH_SYNC;
+    const int sync_offset = is_ft4 ? FT4_SYNC_OFFSET : FT8_SYNC_OFFSET;
+    int score = 0;
+    for (int m = 0; m < num_sync; ++m)
+    {
+        for (int k = 0; k < length_sync; ++k)
+        {
+            int block_abs = candidate->time_offset + (is_ft4 ? 1 : 0) + (sync_offset * m) + k;
+            if (block_abs < 0)
+                continue;
+            if (block_abs >= me->num_blocks)
+                break;
+            int sm = is_ft4 ? kFT4_Costas_pattern[m][k] : kFT8_Costas_pattern[k];
+            score += planes_row(me, me->plane_of[m][k], candidate->time_sub, candidate->freq_sub, block_abs)[candidate->freq_offset + sm];
+        }
+    }
+    int num_average = sync_num_terms(me->protocol, me->num_blocks, candidate->time_offset);
+    return (num_average > 0) ? (score / num_average) : 0;
+}
 
-            int sm = kFT4_Costas_pattern[m][k]; // Index of the expected bin
+#ifdef SYNC_SIMD
+// Sums of the score terms of the SYNC_LANES frequency offsets starting at candidate->freq_offset
+static void planes_score_lanes(const ftx_sync_planes_t* me, const ftx_candidate_t* candidate, int16_t sums[SYNC_LANES])
+{
+    const bool is_ft4 = (me->protocol == FTX_PROTOCOL_FT4);
+    const int num_sync = is_ft4 ? FT4_NUM_SYNC : FT8_NUM_SYNC;
+    const int length_sync = is_ft4 ? FT4_LENGTH_SYNC : FT8_LENGTH_SYNC;
+    const int sync_offset = is_ft4 ? FT4_SYNC_OFFSET : FT8_SYNC_OFFSET;
+    sync_vec_t sum[2] = { SYNC_ZERO(), SYNC_ZERO() };
+    for (int m = 0; m < num_sync; ++m)
+    {
+        for (int k = 0; k < length_sync; ++k)
+        {
+            int block_abs = candidate->time_offset + (is_ft4 ? 1 : 0) + (sync_offset * m) + k;
+            if (block_abs < 0)
+                continue;
+            if (block_abs >= me->num_blocks)
+                break;
+            int sm = is_ft4 ? kFT4_Costas_pattern[m][k] : kFT8_Costas_pattern[k];
+            const int16_t* p = planes_row(me, me->plane_of[m][k], candidate->time_sub, candidate->freq_sub, block_abs) + candidate->freq_offset + sm;
+            sum[0] = SYNC_ADD(sum[0], SYNC_LOAD(p));
+            sum[1] = SYNC_ADD(sum[1], SYNC_LOAD(p + 8));
+        }
+    }
+    SYNC_STORE(sums, sum[0]);
+    SYNC_STORE(sums + 8, sum[1]);
+}
+#endif
 
-            // score += (4 * p4[sm]) - p4[0] - p4[1] - p4[2] - p4[3];
-            // num_average += 4;
+int ftx_find_candidates_planes(const ftx_sync_planes_t* me, int num_candidates, ftx_candidate_t heap[], int min_score)
+{
+    const int num_tones = (me->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+    const int num_offsets = me->num_bins - num_tones + 1;
+    int heap_size = 0;
+    ftx_candidate_t candidate;
 
-            // Check only the neighbors of the expected symbol frequency- and time-wise
-            if (sm > 0)
-            {
-                // look at one frequency bin lower
-                score += WF_ELEM_MAG_INT(p4[sm]) - WF_ELEM_MAG_INT(p4[sm - 1]);
-                ++num_average;
-            }
-            if (sm < 3)
-            {
-                // look at one frequency bin higher
-                score += WF_ELEM_MAG_INT(p4[sm]) - WF_ELEM_MAG_INT(p4[sm + 1]);
-                ++num_average;
-            }
-            if ((k > 0) && (block_abs > 0))
-            {
-                // look one symbol back in time
-                score += WF_ELEM_MAG_INT(p4[sm]) - WF_ELEM_MAG_INT(p4[sm - wf->block_stride]);
-                ++num_average;
-            }
-            if (((k + 1) < FT4_LENGTH_SYNC) && ((block_abs + 1) < wf->num_blocks))
+    for (candidate.time_sub = 0; candidate.time_sub < me->time_osr; ++candidate.time_sub)
+    {
+        for (candidate.freq_sub = 0; candidate.freq_sub < me->freq_osr; ++candidate.freq_sub)
+        {
+            for (candidate.time_offset = -10; candidate.time_offset < 20; ++candidate.time_offset)
             {
-                // look one symbol forward in time
-                score += WF_ELEM_MAG_INT(p4[sm]) - WF_ELEM_MAG_INT(p4[sm + wf->block_stride]);
-                ++num_average;
+#ifdef SYNC_SIMD
+                // Rows are padded, so the lanes past the last frequency offset are only masked out
+                const int num_average = sync_num_terms(me->protocol, me->num_blocks, candidate.time_offset);
+                const int min_sum = sync_min_sum(min_score, num_average);
+                int16_t sums[SYNC_LANES];
+                for (candidate.freq_offset = 0; candidate.freq_offset < num_offsets; candidate.freq_offset += SYNC_LANES)
+                {
+                    planes_score_lanes(me, &candidate, sums);
+                    uint32_t lane_mask = sync_lanes_first(num_offsets - candidate.freq_offset);
+                    heap_size = heap_add_lanes(heap, heap_size, num_candidates, &candidate, sums, lane_mask, num_average, min_sum, NULL);
+                }
+#else
+                for (candidate.freq_offset = 0; candidate.freq_offset < num_offsets; ++candidate.freq_offset)
+                {
+                    candidate.score = ftx_sync_planes_score(me, &candidate);
+                    if (candidate.score < min_score)
+                        continue;
+                    heap_size = heap_add(heap, heap_size, num_candidates, &candidate);
+                }
+#endif
             }
         }
     }
 
-    if (num_average > 0)
-        score /= num_average;
+    heap_sort(heap, heap_size);
+    return heap_size;
+}
 
-    return score;
+size_t ftx_sync_search_size(const ftx_waterfall_t* wf)
+{
+    size_t sums_size = (size_t)wf->time_osr * wf->freq_osr * SEARCH_NUM_OFFSETS * planes_row_stride(wf->num_bins);
+    return (sums_size + 9 * planes_row_stride(wf->num_bins)) * sizeof(int16_t);
 }
 
-int ftx_find_candidates(const ftx_waterfall_t* wf, int num_candidates, ftx_candidate_t heap[], int min_score)
+void ftx_sync_search_init(ftx_sync_search_t* me, const ftx_waterfall_t* wf, void* mem)
 {
-    int (*sync_fun)(const ftx_waterfall_t*, const ftx_candidate_t*) = (wf->protocol == FTX_PROTOCOL_FT4) ? ft4_sync_score : ft8_sync_score;
-    int num_tones = (wf->protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+    me->protocol = wf->protocol;
+    me->num_bins = wf->num_bins;
+    me->time_osr = wf->time_osr;
+    me->freq_osr = wf->freq_osr;
+    me->row_stride = planes_row_stride(wf->num_bins);
+    me->num_planes = planes_assign(wf->protocol, me->plane_of, me->plane_freq, me->plane_time);
+    me->sums = (int16_t*)mem;
+    me->scratch = me->sums + (wf->time_osr * wf->freq_osr * SEARCH_NUM_OFFSETS * me->row_stride);
+    ftx_sync_search_start(me, 0, 0);
+}
 
-    int heap_size = 0;
-    ftx_candidate_t candidate;
+void ftx_sync_search_start(ftx_sync_search_t* me, int block_start, int num_blocks)
+{
+    me->block_start = block_start;
+    me->num_blocks = num_blocks;
+    me->num_received = 0;
+    me->num_done = 0;
+    int sums_size = me->time_osr * me->freq_osr * SEARCH_NUM_OFFSETS * me->row_stride;
+    for (int idx = 0; idx < sums_size; ++idx)
+    {
+        me->sums[idx] = 0;
+    }
+}
 
-    // Here we allow time offsets that exceed signal boundaries, as long as we still have all data bits.
-    // I.e. we can afford to skip the first 7 or the last 7 Costas symbols, as long as we track how many
-    // sync symbols we included in the score, so the score is averaged.
-    for (candidate.time_sub = 0; candidate.time_sub < wf->time_osr; ++candidate.time_sub)
+// Add the sync terms of the next block of the slot to the sums of the candidates using it
+static void search_add_block(ftx_sync_search_t* me, const ftx_waterfall_t* wf, bool has_next)
+{
+    const bool is_ft4 = (me->protocol == FTX_PROTOCOL_FT4);
+    const int num_sync = is_ft4 ? FT4_NUM_SYNC : FT8_NUM_SYNC;
+    const int length_sync = is_ft4 ? FT4_LENGTH_SYNC : FT8_LENGTH_SYNC;
+    const int sync_offset = is_ft4 ? FT4_SYNC_OFFSET : FT8_SYNC_OFFSET;
+    const int num_offsets = me->num_bins - (is_ft4 ? 4 : 8) + 1;
+    const int block = me->num_done;
+    const bool has_prev = (block > 0);
+
+    // Magnitudes of the previous, current and next block, with a zero bin on each side
+    uint8_t rows[3][me->num_bins + U4_TILE_WIDTH + 2];
+    for (int idx = 0; idx < 3; ++idx)
     {
-        for (candidate.freq_sub = 0; candidate.freq_sub < wf->freq_osr; ++candidate.freq_sub)
+        for (int bin = 0; bin < me->num_bins + U4_TILE_WIDTH + 2; ++bin)
         {
-            for (candidate.time_offset = -10; candidate.time_offset < 20; ++candidate.time_offset)
+            rows[idx][bin] = 0;
+        }
+    }
+
+    for (int time_sub = 0; time_sub < me->time_osr; ++time_sub)
+    {
+        for (int freq_sub = 0; freq_sub < me->freq_osr; ++freq_sub)
+        {
+            if (has_prev)
+                load_block_row(wf, me->block_start + block - 1, time_sub, freq_sub, rows[0] + 1);
+            load_block_row(wf, me->block_start + block, time_sub, freq_sub, rows[1] + 1);
+            if (has_next)
+                load_block_row(wf, me->block_start + block + 1, time_sub, freq_sub, rows[2] + 1);
+            planes_fill_rows(me->num_planes, me->plane_freq, me->plane_time, rows[0] + 1, rows[1] + 1, rows[2] + 1, has_prev, has_next,
+                me->num_bins, me->row_stride, me->scratch, me->row_stride);
+
+            // Sync symbols falling on this block, for every time offset searched
+            int16_t* sums = me->sums + (((time_sub * me->freq_osr) + freq_sub) * SEARCH_NUM_OFFSETS * me->row_stride);
+            for (int m = 0; m < num_sync; ++m)
             {
-                for (candidate.freq_offset = 0; (candidate.freq_offset + num_tones - 1) < wf->num_bins; ++candidate.freq_offset)
+                for (int k = 0; k < length_sync; ++k)
                 {
-                    candidate.score = sync_fun(wf, &candidate);
-
-                    if (candidate.score < min_score)
+                    int time_offset = block - (is_ft4 ? 1 : 0) - (sync_offset * m) - k;
+                    if ((time_offset < -10) || (time_offset >= 20))
                         continue;
-
-                    // If the heap is full AND the current candidate is better than
-                    // the worst in the heap, we remove the worst and make space
-                    if ((heap_size == num_candidates) && (candidate.score > heap[0].score))
-                    {
-                        --heap_size;
-                        heap[0] = heap[heap_size];
-                        heapify_down(heap, heap_size);
-                    }
-
-                    // If there's free space in the heap, we add the current candidate
-                    if (heap_size < num_candidates)
+                    int sm = is_ft4 ? kFT4_Costas_pattern[m][k] : kFT8_Costas_pattern[k];
+                    const int16_t* src = me->scratch + (me->plane_of[m][k] * me->row_stride) + sm;
+                    int16_t* dst = sums + ((time_offset + 10) * me->row_stride);
+                    for (int freq_offset = 0; freq_offset < num_offsets; ++freq_offset)
                     {
-                        heap[heap_size] = candidate;
-                        ++heap_size;
-                        heapify_up(heap, heap_size);
+                        dst[freq_offset] += src[freq_offset];
                     }
                 }
             }
         }
     }
+    ++me->num_done;
+}
 
-    // Sort the candidates by sync strength - here we benefit from the heap structure
-    int len_unsorted = heap_size;
-    while (len_unsorted > 1)
+void ftx_sync_search_update(ftx_sync_search_t* me, const ftx_waterfall_t* wf)
+{
+    int num_available = wf->block_count - me->block_start;
+    if (num_available > me->num_blocks)
+        num_available = me->num_blocks;
+    while (me->num_received < num_available)
     {
-        // Take the top (index 0) element which is guaranteed to have the smallest score,
-        // exchange it with the last element in the heap, and decrease the heap size.
-        // Then restore the heap property in the new, smaller heap.
-        // At the end the elements will be sorted in descending order.
-        ftx_candidate_t tmp = heap[len_unsorted - 1];
-        heap[len_unsorted - 1] = heap[0];
-        heap[0] = tmp;
-        len_unsorted--;
-        heapify_down(heap, len_unsorted);
+        ++me->num_received;
+        // A block is added once the next one is known, the last block of the slot right away
+        if (me->num_received >= 2)
+            search_add_block(me, wf, true);
+        if (me->num_received == me->num_blocks)
+            search_add_block(me, wf, false);
+    }
+}
+
+int ftx_sync_search_candidates(ftx_sync_search_t* me, const ftx_waterfall_t* wf, int time_offset_min, int time_offset_max, int num_candidates, ftx_candidate_t heap[], int min_score)
+{
+    ftx_sync_search_update(me, wf);
+    if (me->num_done < me->num_received)
+        search_add_block(me, wf, false);
+    // The slot ends here, even if it is shorter than expected
+    me->num_blocks = me->num_received;
+
+    // Only the sums of the time offsets in the window are ranked
+    if (time_offset_min < -10)
+        time_offset_min = -10;
+    if (time_offset_max > SEARCH_NUM_OFFSETS - 11)
+        time_offset_max = SEARCH_NUM_OFFSETS - 11;
+
+    const int num_offsets = me->num_bins - ((me->protocol == FTX_PROTOCOL_FT4) ? 4 : 8) + 1;
+    int heap_size = 0;
+    ftx_candidate_t candidate;
+    for (candidate.time_sub = 0; candidate.time_sub < me->time_osr; ++candidate.time_sub)
+    {
+        for (candidate.freq_sub = 0; candidate.freq_sub < me->freq_osr; ++candidate.freq_sub)
+        {
+            for (candidate.time_offset = time_offset_min; candidate.time_offset <= time_offset_max; ++candidate.time_offset)
+            {
+                const int num_average = sync_num_terms(me->protocol, me->num_blocks, candidate.time_offset);
+                const int sub = (candidate.time_sub * me->freq_osr) + candidate.freq_sub;
+                const int16_t* sums = me->sums + (((sub * SEARCH_NUM_OFFSETS) + candidate.time_offset + 10) * me->row_stride);
+#ifdef SYNC_SIMD
+                // Rows are padded, so the lanes past the last frequency offset are only masked out
+                const int min_sum = sync_min_sum(min_score, num_average);
+                for (candidate.freq_offset = 0; candidate.freq_offset < num_offsets; candidate.freq_offset += SYNC_LANES)
+                {
+                    uint32_t lane_mask = sync_lanes_first(num_offsets - candidate.freq_offset);
+                    heap_size = heap_add_lanes(heap, heap_size, num_candidates, &candidate, sums + candidate.freq_offset, lane_mask, num_average, min_sum, NULL);
+                }
+#else
+                for (candidate.freq_offset = 0; candidate.freq_offset < num_offsets; ++candidate.freq_offset)
+                {
+                    candidate.score = (num_average > 0) ? (sums[candidate.freq_offset] / num_average) : 0;
+                    if (candidate.score < min_score)
+                        continue;
+                    heap_size = heap_add(heap, heap_size, num_candidates, &candidate);
+                }
+#endif
+            }
+        }
     }
 
+    heap_sort(heap, heap_size);
     return heap_size;
 }
+#endif
 
 static void ft4_extract_likelihood(const ftx_waterfall_t* wf, const ftx_candidate_t* cand, float* log174)
 {
-    const WF_ELEM_T* mag = get_cand_mag(wf, cand); // Pointer to 4 magnitude bins of the first symbol
+    const int view_first = get_view_first(wf);
+    WF_ELEM_T scratch[U4_TILE_WIDTH];
 
     // Go over FSK tones and skip Costas sync symbols
     for (int k = 0; k < FT4_ND; ++k)
@@ -271,14 +1742,15 @@ static void ft4_extract_likelihood(const ftx_waterfall_t* wf, const ftx_candidat
         }
         else
         {
-            ft4_extract_symbol(mag + (sym_idx * wf->block_stride), log174 + bit_idx);
+            ft4_extract_symbol(get_cand_tones(wf, view_first, cand, block, scratch), log174 + bit_idx);
         }
     }
 }
 
 static void ft8_extract_likelihood(const ftx_waterfall_t* wf, const ftx_candidate_t* cand, float* log174)
 {
-    const WF_ELEM_T* mag = get_cand_mag(wf, cand); // Pointer to 8 magnitude bins of the first symbol
+    const int view_first = get_view_first(wf);
+    WF_ELEM_T scratch[U4_TILE_WIDTH];
 
     // Go over FSK tones and skip Costas sync symbols
     for (int k = 0; k < FT8_ND; ++k)
@@ -298,7 +1770,7 @@ static void ft8_extract_likelihood(const ftx_waterfall_t* wf, const ftx_candidat
         }
         else
         {
-            ft8_extract_symbol(mag + (sym_idx * wf->block_stride), log174 + bit_idx);
+            ft8_extract_symbol(get_cand_tones(wf, view_first, cand, block, scratch), log174 + bit_idx);
         }
     }
 }
@@ -324,9 +1796,8 @@ static void ftx_normalize_logl(float* log174)
     }
 }
 
-bool ftx_decode_candidate(const ftx_waterfall_t* wf, const ftx_candidate_t* cand, int max_iterations, ftx_message_t* message, ftx_decode_status_t* status)
+static void ftx_extract_logl(const ftx_waterfall_t* wf, const ftx_candidate_t* cand, float log174[])
 {
-    float log174[FTX_LDPC_N]; // message bits encoded as likelihood
     if (wf->protocol == FTX_PROTOCOL_FT4)
     {
         ft4_extract_likelihood(wf, cand, log174);
@@ -337,11 +1808,11 @@ bool ftx_decode_candidate(const ftx_waterfall_t* wf, const ftx_candidate_t* cand
     }
 
     ftx_normalize_logl(log174);
+}
 
-    uint8_t plain174[FTX_LDPC_N]; // message bits (0/1)
-    bp_decode(log174, max_iterations, plain174, &status->ldpc_errors);
-    // ldpc_decode(log174, max_iterations, plain174, &status->ldpc_errors);
-
+// Check the CRC of the LDPC decoded bits and extract the payload
+static bool ftx_decode_plain(const ftx_waterfall_t* wf, const uint64_t plain174[], ftx_message_t* message, ftx_decode_status_t* status)
+{
     if (status->ldpc_errors > 0)
     {
         return false;
@@ -387,6 +1858,58 @@ bool ftx_decode_candidate(const ftx_waterfall_t* wf, const ftx_candidate_t* cand
     return true;
 }
 
+bool ftx_decode_candidate(const ftx_waterfall_t* wf, const ftx_candidate_t* cand, int max_iterations, ftx_message_t* message, ftx_decode_status_t* status)
+{
+    float log174[FTX_LDPC_N]; // message bits encoded as likelihood
+    ftx_extract_logl(wf, cand, log174);
+
+    uint64_t plain174[FTX_LDPC_N_WORDS]; // message bits (packed)
+#if defined(FTX_LDPC_LAYERED)
+    layered_decode(log174, max_iterations, plain174, &status->ldpc_errors);
+#elif defined(FTX_LDPC_MIN_SUM)
+    min_sum_decode(log174, max_iterations, plain174, &status->ldpc_errors);
+#else
+    bp_decode(log174, max_iterations, plain174, &status->ldpc_errors);
+#endif
+    // ldpc_decode(log174, max_iterations, plain174, &status->ldpc_errors);
+
+    return ftx_decode_plain(wf, plain174, message, status);
+}
+
+int ftx_decode_candidates_batch(const ftx_waterfall_t* wf, const ftx_candidate_t candidates[], int num_candidates, int max_iterations, ftx_message_t messages[], ftx_decode_status_t status[], bool decoded[])
+{
+    int num_decoded = 0;
+    for (int start = 0; start < num_candidates; start += FTX_LDPC_BATCH)
+    {
+        int num_batch = num_candidates - start;
+        if (num_batch > FTX_LDPC_BATCH)
+        {
+            num_batch = FTX_LDPC_BATCH;
+        }
+
+        float log174[FTX_LDPC_BATCH][FTX_LDPC_N];
+        for (int i = 0; i < num_batch; ++i)
+        {
+            ftx_extract_logl(wf, &candidates[start + i], log174[i]);
+        }
+
+        uint64_t plain174[FTX_LDPC_BATCH][FTX_LDPC_N_WORDS];
+        int ldpc_errors[FTX_LDPC_BATCH];
+        min_sum_decode_batch(log174, num_batch, max_iterations, plain174, ldpc_errors);
+
+        for (int i = 0; i < num_batch; ++i)
+        {
+            status[start + i].ldpc_errors = ldpc_errors[i];
+            decoded[start + i] = ftx_decode_plain(wf, plain174[i], &messages[start + i], &status[start + i]);
+            if (decoded[start + i])
+            {
+                ++num_decoded;
+            }
+        }
+    }
+    return num_decoded;
+}
+
 static float max2(float a, float b)
 {
     return (a >= b) ? a : b;
@@ -564,29 +2087,17 @@ static void ft8_decode_multi_symbols(const WF_ELEM_T* wf, int num_bins, int n_sy
     }
 }
 
-// Packs a string of bits each represented as a zero/non-zero byte in plain[],
+// Packs the first num_bits of a string of bits packed into 64-bit words (MSB first),
 // as a string of packed bits starting from the MSB of the first byte of packed[]
-static void pack_bits(const uint8_t bit_array[], int num_bits, uint8_t packed[])
+static void pack_bits(const uint64_t bit_words[], int num_bits, uint8_t packed[])
 {
     int num_bytes = (num_bits + 7) / 8;
     for (int i = 0; i < num_bytes; ++i)
     {
-        packed[i] = 0;
+        packed[i] = (uint8_t)(bit_words[i / 8] >> (56 - 8 * (i % 8)));
     }
-
-    uint8_t mask = 0x80;
-    int byte_idx = 0;
-    for (int i = 0; i < num_bits; ++i)
+    if (num_bits % 8 != 0)
     {
-        if (bit_array[i])
-        {
-            packed[byte_idx] |= mask;
-        }
-        mask >>= 1;
-        if (!mask)
-        {
-            mask = 0x80;
-            ++byte_idx;
-        }
+        packed[num_bytes - 1] &= (uint8_t)(0xFF << (8 - num_bits % 8));
     }
 }
\ No newline at end of file
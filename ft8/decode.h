@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "constants.h"
 #include "message.h"
@@ -30,24 +31,86 @@ typedef struct
 #define WF_ELEM_MAG_INT(x) (int)(x)
 #endif
 
+/// Memory layout of the waterfall magnitudes
+typedef enum
+{
+    FTX_WATERFALL_LAYOUT_BLOCKS, ///< mag[blocks][time_osr][freq_osr][num_bins] (default)
+    FTX_WATERFALL_LAYOUT_PLANES  ///< mag[time_osr][freq_osr][blocks][num_bins], one contiguous plane per subdivision
+} ftx_waterfall_layout_t;
+
+/// Storage format of the waterfall magnitudes
+typedef enum
+{
+    FTX_WATERFALL_FORMAT_U8, ///< One magnitude code per bin (default)
+    FTX_WATERFALL_FORMAT_U4  ///< Compact rows: a base code (noise floor) followed by 4-bit codes, two bins per byte
+} ftx_waterfall_format_t;
+
+/// Extra bytes to allocate after the mag array of a compact (FTX_WATERFALL_FORMAT_U4) waterfall
+#define FTX_WATERFALL_U4_PADDING 16
+
+/// Size in bytes of one row of num_bins magnitudes in a compact waterfall
+#define FTX_WATERFALL_U4_ROW_SIZE(num_bins) (1 + ((num_bins) + 1) / 2)
+
 /// Input structure to ftx_find_sync() function. This structure describes stored waterfall data over the whole message slot.
 /// Fields time_osr and freq_osr specify additional oversampling rate for time and frequency resolution.
 /// If time_osr=1, FFT magnitude data is collected once for every symbol transmitted, i.e. every 1/6.25 = 0.16 seconds.
 /// Values time_osr > 1 mean each symbol is further subdivided in time.
 /// If freq_osr=1, each bin in the FFT magnitude data corresponds to 6.25 Hz, which is the tone spacing.
 /// Values freq_osr > 1 mean the tone spacing is further subdivided by FFT analysis.
+/// The mag array is used as a ring buffer: the block with absolute index (symbol time) n is stored at n % max_blocks.
+/// Candidate time offsets are relative to the current view, which starts at block_start and has num_blocks blocks.
+/// A single-slot waterfall simply has block_start = 0 and num_blocks = block_count.
 typedef struct
 {
     int max_blocks;          ///< number of blocks (symbols) allocated in the mag array
-    int num_blocks;          ///< number of blocks (symbols) stored in the mag array
+    int num_blocks;          ///< number of blocks (symbols) in the current view
+    int block_start;         ///< absolute index of the first block in the current view
+    int block_count;         ///< number of blocks stored so far (absolute index of the next block)
     int num_bins;            ///< number of FFT bins in terms of 6.25 Hz
     int time_osr;            ///< number of time subdivisions
     int freq_osr;            ///< number of frequency subdivisions
-    WF_ELEM_T* mag;          ///< FFT magnitudes stored as uint8_t[blocks][time_osr][freq_osr][num_bins]
-    int block_stride;        ///< Helper value = time_osr * freq_osr * num_bins
+    WF_ELEM_T* mag;          ///< FFT magnitudes stored as uint8_t[blocks][time_osr][freq_osr][num_bins] (see layout and format)
+    int row_stride;          ///< Size of one row (num_bins magnitudes) in the mag array: num_bins, or FTX_WATERFALL_U4_ROW_SIZE(num_bins)
+    int block_stride;        ///< Helper value = time_osr * freq_osr * row_stride
+    ftx_waterfall_layout_t layout; ///< Memory layout of the mag array
+    ftx_waterfall_format_t format; ///< Storage format of the mag array (FTX_WATERFALL_FORMAT_U4 requires uint8_t magnitudes)
     ftx_protocol_t protocol; ///< Indicate if using FT4 or FT8
 } ftx_waterfall_t;
 
+/// Get the magnitudes of the num_bins frequency bins of a block for one time and frequency subdivision.
+/// This is the only place that knows about the memory layout of the waterfall.
+/// With FTX_WATERFALL_FORMAT_U4, this is the start of the packed row (see ftx_waterfall_store_row()).
+/// @param[in] wf Waterfall
+/// @param[in] block Position of the block in the mag array (0 <= block < max_blocks)
+/// @param[in] time_sub Time subdivision
+/// @param[in] freq_sub Frequency subdivision
+static inline WF_ELEM_T* ftx_waterfall_row(const ftx_waterfall_t* wf, int block, int time_sub, int freq_sub)
+{
+    int sub = (time_sub * wf->freq_osr) + freq_sub;
+    int row = (wf->layout == FTX_WATERFALL_LAYOUT_PLANES) ? ((sub * wf->max_blocks) + block) : ((block * wf->time_osr * wf->freq_osr) + sub);
+    return wf->mag + (row * wf->row_stride);
+}
+
+/// Distance (in elements) between the same frequency bin of two consecutive blocks in the mag array
+static inline int ftx_waterfall_block_step(const ftx_waterfall_t* wf)
+{
+    return (wf->layout == FTX_WATERFALL_LAYOUT_PLANES) ? wf->row_stride : wf->block_stride;
+}
+
+#ifndef WATERFALL_USE_PHASE
+/// Store the magnitude codes of one row (block, time and frequency subdivision) in the waterfall format.
+/// A compact row keeps a base code near the noise floor of the row, followed by 4-bit codes of the level above it:
+/// 2 dB steps up to 14 dB, then 4 dB steps up to 46 dB. Stronger bins saturate, which is meant for receiver audio
+/// with a noise floor (a noiseless synthetic signal loses the difference between neighboring tones).
+/// @param[in,out] wf Waterfall
+/// @param[in] block Position of the block in the mag array (0 <= block < max_blocks)
+/// @param[in] time_sub Time subdivision
+/// @param[in] freq_sub Frequency subdivision
+/// @param[in] mag Magnitude codes of the row, bin i is mag[i * mag_step]
+/// @param[in] mag_step Distance between consecutive bins in mag
+void ftx_waterfall_store_row(ftx_waterfall_t* wf, int block, int time_sub, int freq_sub, const uint8_t* mag, int mag_step);
+#endif
+
 /// Output structure of ftx_find_sync() and input structure of ftx_decode().
 /// Holds the position of potential start of a message in time and frequency.
 typedef struct
@@ -70,6 +133,14 @@ typedef struct
     // int unpack_status;       ///< Return value of the unpack routine
 } ftx_decode_status_t;
 
+/// Select the part of a (rolling) waterfall seen by ftx_find_candidates() and ftx_decode_candidate().
+/// The view is clamped to the blocks still stored in the waterfall.
+/// @param[in,out] wf Waterfall
+/// @param[in] block_start Absolute index of the first block, e.g. the start of a time slot in symbol periods
+/// @param[in] num_blocks Number of blocks in the view
+/// @return Number of blocks in the resulting view
+int ftx_waterfall_set_view(ftx_waterfall_t* wf, int block_start, int num_blocks);
+
 /// Localize top N candidates in frequency and time according to their sync strength (looking at Costas symbols)
 /// We treat and organize the candidate list as a min-heap (empty initially).
 /// @param[in] power Waterfall data collected during message slot
@@ -80,6 +151,203 @@ typedef struct
 /// @return Number of candidates filled in the heap
 int ftx_find_candidates(const ftx_waterfall_t* power, int num_candidates, ftx_candidate_t heap[], int min_score);
 
+/// Parameters of ftx_find_candidates_coarse()
+typedef struct
+{
+    int time_offset_min; ///< First time offset searched, in blocks (-10 in ftx_find_candidates())
+    int time_offset_max; ///< Last time offset searched, in blocks (19 in ftx_find_candidates())
+    int num_coarse;      ///< Number of best coarse positions around which the subdivisions are searched
+    int coarse_margin;   ///< Coarse positions need a score of min_score - coarse_margin (signals between subdivisions score lower)
+} ftx_search_params_t;
+
+/// Memory needed by ftx_find_candidates_coarse() for a waterfall and search parameters
+/// @param[in] power Waterfall
+/// @param[in] params Search window and number of coarse positions
+/// @return Size in bytes
+size_t ftx_find_candidates_coarse_size(const ftx_waterfall_t* power, const ftx_search_params_t* params);
+
+/// Coarse-to-fine candidate search within a window of time offsets. A coarse pass scores only the first time and
+/// frequency subdivision (as if there were no oversampling) and keeps the num_coarse best positions. The fine pass
+/// then scores all subdivisions within one symbol period and one tone spacing around each of them.
+/// @param[in] power Waterfall data collected during message slot
+/// @param[in] params Search window and number of coarse positions
+/// @param[in] mem Scratch memory (at least ftx_find_candidates_coarse_size() bytes, aligned for ftx_candidate_t)
+/// @param[in] num_candidates Number of maximum candidates (size of heap array)
+/// @param[in,out] heap Array of ftx_candidate_t type entries (with num_candidates allocated entries)
+/// @param[in] min_score Minimal score of both coarse positions and candidates
+/// @return Number of candidates filled in the heap
+int ftx_find_candidates_coarse(const ftx_waterfall_t* power, const ftx_search_params_t* params, void* mem, int num_candidates, ftx_candidate_t heap[], int min_score);
+
+/// Window of positions searched by ftx_find_candidates_windows(), e.g. around a known frequency
+typedef struct
+{
+    int freq_offset_min; ///< First frequency offset (bin of the lowest tone)
+    int freq_offset_max; ///< Last frequency offset
+    int time_offset_min; ///< First time offset, in blocks (at least -10, as in ftx_find_candidates())
+    int time_offset_max; ///< Last time offset, in blocks (at most 19, as in ftx_find_candidates())
+} ftx_search_window_t;
+
+/// Same as ftx_find_candidates(), searching only the positions within a list of windows (e.g. the own transmit
+/// frequency, the frequency of a QSO partner or of a CQ caller), so that the messages of interest can be decoded
+/// first, right at the end of the slot, before the full search. Candidates have the same scores as in
+/// ftx_find_candidates(), and positions in overlapping windows are searched once.
+/// @param[in] power Waterfall data collected during message slot
+/// @param[in] windows Windows to search, clamped to the positions searched by ftx_find_candidates()
+/// @param[in] num_windows Number of windows
+/// @param[in] num_candidates Number of maximum candidates (size of heap array)
+/// @param[in,out] heap Array of ftx_candidate_t type entries (with num_candidates allocated entries)
+/// @param[in] min_score Minimal score allowed for pruning unlikely candidates (can be zero for no effect)
+/// @return Number of candidates filled in the heap
+int ftx_find_candidates_windows(const ftx_waterfall_t* power, const ftx_search_window_t windows[], int num_windows, int num_candidates, ftx_candidate_t heap[], int min_score);
+
+/// Largest number of threads used by ftx_find_candidates_parallel()
+#define FTX_MAX_THREADS 16
+
+/// Memory needed by ftx_find_candidates_parallel() for the heaps of the threads and the candidates they log
+/// @param[in] num_threads Number of threads, including the calling thread
+/// @param[in] num_candidates Number of maximum candidates
+/// @return Size in bytes (zero if the library is built without FTX_USE_THREADS)
+size_t ftx_find_candidates_parallel_size(int num_threads, int num_candidates);
+
+/// Same as ftx_find_candidates(), with the search split in contiguous ranges of time offsets (and subdivisions)
+/// searched by num_threads threads, each with its own heap. The heaps are merged into exactly the same output
+/// as ftx_find_candidates(). Threads are only used when the library is built with FTX_USE_THREADS (POSIX threads);
+/// otherwise, or if num_threads < 2, this is ftx_find_candidates().
+/// @param[in] power Waterfall data collected during message slot
+/// @param[in] num_threads Number of threads, including the calling thread (at most FTX_MAX_THREADS)
+/// @param[in] mem Scratch memory (at least ftx_find_candidates_parallel_size() bytes, aligned for ftx_candidate_t)
+/// @param[in] num_candidates Number of maximum candidates (size of heap array)
+/// @param[in,out] heap Array of ftx_candidate_t type entries (with num_candidates allocated entries)
+/// @param[in] min_score Minimal score allowed for pruning unlikely candidates (can be zero for no effect)
+/// @return Number of candidates filled in the heap
+int ftx_find_candidates_parallel(const ftx_waterfall_t* power, int num_threads, void* mem, int num_candidates, ftx_candidate_t heap[], int min_score);
+
+#ifndef WATERFALL_USE_PHASE
+/// Memory needed by ftx_find_candidates_bucketed() for a waterfall (the sync scores of all positions)
+/// @param[in] power Waterfall
+/// @return Size in bytes
+size_t ftx_find_candidates_bucketed_size(const ftx_waterfall_t* power);
+
+/// Same candidates as ftx_find_candidates(), selected without a heap: the sync scores of all positions are stored
+/// and counted by score, which gives the lowest score selected, and a counting sort then places the selected
+/// positions in order. Candidates with equal scores are in the order of the search (time subdivision, frequency
+/// subdivision, time offset, frequency offset), where the heap of ftx_find_candidates() leaves them in an order
+/// that depends on its history; the scores and the candidates above the lowest score selected are the same.
+/// @param[in] power Waterfall data collected during message slot
+/// @param[in] mem Scratch memory (at least ftx_find_candidates_bucketed_size() bytes, aligned for int16_t)
+/// @param[in] num_candidates Number of maximum candidates (size of candidates array)
+/// @param[out] candidates Array of ftx_candidate_t type entries (with num_candidates allocated entries), sorted by descending score
+/// @param[in] min_score Minimal score allowed for pruning unlikely candidates (can be zero for no effect)
+/// @return Number of candidates filled in the array
+int ftx_find_candidates_bucketed(const ftx_waterfall_t* power, void* mem, int num_candidates, ftx_candidate_t candidates[], int min_score);
+#endif
+
+/// Non-maximum suppression: drop the candidates that have a better (or equal) candidate within a time and frequency
+/// radius, i.e. the neighbors of a strong signal found at adjacent subdivisions, bins or blocks. The candidates are
+/// compacted in place, keeping their order.
+/// @param[in] power Waterfall the candidates were found in (for the number of subdivisions)
+/// @param[in] num_candidates Number of candidates
+/// @param[in,out] candidates Candidates sorted by descending score, as returned by ftx_find_candidates()
+/// @param[in] time_radius Suppression radius in time subdivisions (time_osr per block)
+/// @param[in] freq_radius Suppression radius in frequency subdivisions (freq_osr per bin)
+/// @return Number of candidates kept
+int ftx_prune_candidates(const ftx_waterfall_t* power, int num_candidates, ftx_candidate_t candidates[], int time_radius, int freq_radius);
+
+#ifndef WATERFALL_USE_PHASE
+/// Sync difference planes of a waterfall view. The sync score of a candidate adds up, for every Costas symbol,
+/// the differences between the expected cell and its frequency and time neighbors. The planes hold these sums
+/// for every cell, one plane per combination of neighbors used by the sync pattern (4 for FT8, 9 for FT4),
+/// so that a sync score is a sum of 21 (FT8) or 16 (FT4) lookups. Built once per slot (view) by
+/// ftx_sync_planes_build(), they are independent of the waterfall format and of the ring buffer wrap-around.
+typedef struct
+{
+    ftx_protocol_t protocol; ///< Protocol of the sync pattern
+    int num_blocks;          ///< Number of blocks in the view
+    int num_bins;            ///< Number of frequency bins
+    int time_osr;            ///< Number of time subdivisions
+    int freq_osr;            ///< Number of frequency subdivisions
+    int row_stride;          ///< Values per row (num_bins plus zero padding for vector loads)
+    int num_planes;          ///< Number of neighbor combinations used by the sync pattern
+    uint8_t plane_of[FT4_NUM_SYNC][FT8_LENGTH_SYNC]; ///< Plane of each sync symbol (group m, symbol k)
+    int16_t* diff;           ///< Sums of differences, diff[plane][time_sub][freq_sub][block][row_stride]
+} ftx_sync_planes_t;
+
+/// Memory needed by ftx_sync_planes_build() for views of the waterfall (up to max_blocks blocks)
+/// @param[in] wf Waterfall
+/// @return Size in bytes
+size_t ftx_sync_planes_size(const ftx_waterfall_t* wf);
+
+/// Build the sync difference planes of the current view of a waterfall
+/// @param[out] planes Sync difference planes
+/// @param[in] wf Waterfall
+/// @param[in] mem Memory for the planes (at least ftx_sync_planes_size() bytes, aligned for int16_t)
+void ftx_sync_planes_build(ftx_sync_planes_t* planes, const ftx_waterfall_t* wf, void* mem);
+
+/// Sync score of a candidate, identical to the score computed by ftx_find_candidates() (e.g. for refinement)
+int ftx_sync_planes_score(const ftx_sync_planes_t* planes, const ftx_candidate_t* candidate);
+
+/// Same as ftx_find_candidates(), with the sync scores computed from the sync difference planes
+int ftx_find_candidates_planes(const ftx_sync_planes_t* planes, int num_candidates, ftx_candidate_t heap[], int min_score);
+
+/// Incremental candidate search over one slot. Instead of scanning the whole slot once it has been captured,
+/// the partial sync sums of all candidates are updated as blocks are stored in the waterfall
+/// (e.g. from the block callback of the monitor), so that at the end of the slot only the last block
+/// remains to be added before ranking the candidates.
+typedef struct
+{
+    ftx_protocol_t protocol; ///< Protocol of the sync pattern
+    int num_bins;            ///< Number of frequency bins
+    int time_osr;            ///< Number of time subdivisions
+    int freq_osr;            ///< Number of frequency subdivisions
+    int row_stride;          ///< Values per row of the scratch planes
+    int num_planes;          ///< Number of neighbor combinations used by the sync pattern
+    uint8_t plane_of[FT4_NUM_SYNC][FT8_LENGTH_SYNC]; ///< Plane of each sync symbol (group m, symbol k)
+    uint8_t plane_freq[9];   ///< Frequency neighbors of each plane
+    uint8_t plane_time[9];   ///< Time neighbors of each plane
+    int block_start;         ///< Absolute index of the first block of the slot
+    int num_blocks;          ///< Maximum number of blocks of the slot
+    int num_received;        ///< Number of blocks of the slot seen so far
+    int num_done;            ///< Number of blocks added to the sums (a block needs the next one)
+    int16_t* sums;           ///< Partial sync sums, sums[time_sub][freq_sub][time_offset + 10][num_bins]
+    int16_t* scratch;        ///< Planes of one block, scratch[num_planes][row_stride]
+} ftx_sync_search_t;
+
+/// Memory needed by ftx_sync_search_init() for a waterfall
+/// @param[in] wf Waterfall
+/// @return Size in bytes
+size_t ftx_sync_search_size(const ftx_waterfall_t* wf);
+
+/// Initialize an incremental search for the protocol and dimensions of a waterfall
+/// @param[out] search Incremental search
+/// @param[in] wf Waterfall
+/// @param[in] mem Memory for the search (at least ftx_sync_search_size() bytes, aligned for int16_t)
+void ftx_sync_search_init(ftx_sync_search_t* search, const ftx_waterfall_t* wf, void* mem);
+
+/// Start the search of a slot, discarding the previous one
+/// @param[in,out] search Incremental search
+/// @param[in] block_start Absolute index of the first block of the slot
+/// @param[in] num_blocks Number of blocks in the slot (the view later passed to ftx_decode_candidate())
+void ftx_sync_search_start(ftx_sync_search_t* search, int block_start, int num_blocks);
+
+/// Add the blocks of the slot stored in the waterfall since the last call
+/// (they must still be in the waterfall, i.e. call at least once every max_blocks blocks)
+void ftx_sync_search_update(ftx_sync_search_t* search, const ftx_waterfall_t* wf);
+
+/// End the search of the slot and rank its candidates within a window of time offsets. Over all time offsets
+/// (-10 .. 19) the result is identical to ftx_find_candidates() over the view (block_start, number of blocks received),
+/// and over a narrower window to ftx_find_candidates_windows() with that window over all frequency offsets.
+/// Call ftx_sync_search_start() before searching again.
+/// @param[in,out] search Incremental search
+/// @param[in] wf Waterfall
+/// @param[in] time_offset_min First time offset ranked (in blocks)
+/// @param[in] time_offset_max Last time offset ranked (in blocks)
+/// @param[in] num_candidates Number of maximum candidates (size of heap array)
+/// @param[in,out] heap Array of ftx_candidate_t type entries (with num_candidates allocated entries)
+/// @param[in] min_score Minimal score allowed for pruning unlikely candidates
+/// @return Number of candidates filled in the heap
+int ftx_sync_search_candidates(ftx_sync_search_t* search, const ftx_waterfall_t* wf, int time_offset_min, int time_offset_max, int num_candidates, ftx_candidate_t heap[], int min_score);
+#endif
+
 /// Attempt to decode a message candidate. Extracts the bit probabilities, runs LDPC decoder, checks CRC and unpacks the message in plain text.
 /// @param[in] power Waterfall data collected during message slot
 /// @param[in] cand Candidate to decode
@@ -89,6 +357,19 @@ int ftx_find_candidates(const ftx_waterfall_t* power, int num_candidates, ftx_ca
 /// @return True if the decoding was successful, false otherwise (check status for details)
 bool ftx_decode_candidate(const ftx_waterfall_t* power, const ftx_candidate_t* cand, int max_iterations, ftx_message_t* message, ftx_decode_status_t* status);
 
+/// Attempt to decode a list of candidates, like ftx_decode_candidate() but with the min-sum LDPC decoder running on
+/// several candidates at once in vector lanes (min_sum_decode_batch()). Most candidates fail after the full number of
+/// iterations, so this has a much higher throughput than decoding them one by one.
+/// @param[in] power Waterfall data collected during message slot
+/// @param[in] candidates Array of candidates
+/// @param[in] num_candidates Number of candidates
+/// @param[in] max_iterations Maximum allowed LDPC iterations
+/// @param[out] messages Array of num_candidates messages, valid where decoded is true
+/// @param[out] status Array of num_candidates decoding status structures
+/// @param[out] decoded Array of num_candidates flags, true where the decoding was successful
+/// @return Number of successfully decoded candidates
+int ftx_decode_candidates_batch(const ftx_waterfall_t* power, const ftx_candidate_t candidates[], int num_candidates, int max_iterations, ftx_message_t messages[], ftx_decode_status_t status[], bool decoded[]);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,19 +16,91 @@
 #include <math.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
-static int ldpc_check(uint8_t codeword[]);
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+static int ldpc_check(const uint64_t codeword[]);
 static float fast_tanh(float x);
 static float fast_atanh(float x);
 
+// Hard decisions are packed 64 bits per word starting from the MSB, like kFTX_LDPC_Check_mask
+#define LDPC_BIT_SHIFT(n) (63 - ((n) & 63))
+
+// Size of the byte per bit hard decisions given to ldpc_pack(), padded to whole words
+#define LDPC_HARD_BYTES (FTX_LDPC_N_WORDS * 64)
+
+static inline int popcount64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+static inline int parity64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_parityll(x);
+#else
+    return popcount64(x) & 1;
+#endif
+}
+
+// Are all the bits of a packed hard decision (or syndrome) zero?
+static inline bool ldpc_is_zero(const uint64_t words[], int num_words)
+{
+    uint64_t x = 0;
+    for (int w = 0; w < num_words; ++w)
+    {
+        x |= words[w];
+    }
+    return (x == 0);
+}
+
+// Packs hard decisions made one byte (0 or 1) per bit, which is a loop that vectorizes well, into words.
+// The multiplication gathers 8 bytes at a time: it moves byte k of a 64-bit word to bit 63 - k
+// (all the partial products land on distinct bits, so there are no carries).
+static void ldpc_pack(const uint8_t hard[LDPC_HARD_BYTES], uint64_t plain[])
+{
+    for (int w = 0; w < FTX_LDPC_N_WORDS; ++w)
+    {
+        uint64_t x = 0;
+        for (int k = 0; k < 8; ++k)
+        {
+            const uint8_t* b = &hard[64 * w + 8 * k];
+            uint64_t bytes = 0;
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+            memcpy(&bytes, b, 8);
+#else
+            for (int i = 0; i < 8; ++i)
+            {
+                bytes |= (uint64_t)b[i] << (8 * i);
+            }
+#endif
+            x |= ((bytes * 0x8040201008040201ull) >> 56) << (56 - 8 * k);
+        }
+        plain[w] = x;
+    }
+}
+
 // codeword is 174 log-likelihoods.
-// plain is a return value, 174 ints, to be 0 or 1.
+// plain is a return value, 174 bits packed into FTX_LDPC_N_WORDS words (see kFTX_LDPC_Check_mask).
 // max_iters is how hard to try.
 // ok == 87 means success.
-void ldpc_decode(float codeword[], int max_iters, uint8_t plain[], int* ok)
+void ldpc_decode(float codeword[], int max_iters, uint64_t plain[], int* ok)
 {
     float m[FTX_LDPC_M][FTX_LDPC_N]; // ~60 kB
     float e[FTX_LDPC_M][FTX_LDPC_N]; // ~60 kB
+    uint8_t hard[LDPC_HARD_BYTES] = { 0 };
     int min_errors = FTX_LDPC_M;
 
     for (int j = 0; j < FTX_LDPC_M; j++)
@@ -65,8 +137,9 @@ void ldpc_decode(float codeword[], int max_iters, uint8_t plain[], int* ok)
             float l = codeword[i];
             for (int j = 0; j < 3; j++)
                 l += e[kFTX_LDPC_Mn[i][j] - 1][i];
-            plain[i] = (l > 0) ? 1 : 0;
+            hard[i] = (l > 0) ? 1 : 0;
         }
+        ldpc_pack(hard, plain);
 
         int errors = ldpc_check(plain);
 
@@ -103,34 +176,59 @@ void ldpc_decode(float codeword[], int max_iters, uint8_t plain[], int* ok)
     *ok = min_errors;
 }
 
+// Parity of the bits of a packed 174-bit codeword in parity check m, 1 when the check fails
+static inline int ldpc_check_parity(const uint64_t codeword[], int m)
+{
+    uint64_t x = 0;
+    for (int w = 0; w < FTX_LDPC_N_WORDS; ++w)
+    {
+        x ^= codeword[w] & kFTX_LDPC_Check_mask[m][w];
+    }
+    return parity64(x);
+}
+
+// Syndrome of a packed 174-bit codeword, packed in the same way: bit m is set when parity check m fails
+static void ldpc_syndrome(const uint64_t codeword[], uint64_t syndrome[])
+{
+    memset(syndrome, 0, FTX_LDPC_M_WORDS * sizeof(syndrome[0]));
+    for (int m = 0; m < FTX_LDPC_M; ++m)
+    {
+        syndrome[m / 64] |= (uint64_t)ldpc_check_parity(codeword, m) << LDPC_BIT_SHIFT(m);
+    }
+}
+
+// Number of failed parity checks (set bits) in a syndrome
+static int ldpc_syndrome_weight(const uint64_t syndrome[])
+{
+    int weight = 0;
+    for (int w = 0; w < FTX_LDPC_M_WORDS; ++w)
+    {
+        weight += popcount64(syndrome[w]);
+    }
+    return weight;
+}
+
 //
 // does a 174-bit codeword pass the FT8's LDPC parity checks?
 // returns the number of parity errors.
 // 0 means total success.
 //
-static int ldpc_check(uint8_t codeword[])
+static int ldpc_check(const uint64_t codeword[])
 {
     int errors = 0;
 
     for (int m = 0; m < FTX_LDPC_M; ++m)
     {
-        uint8_t x = 0;
-        for (int i = 0; i < kFTX_LDPC_Num_rows[m]; ++i)
-        {
-            x ^= codeword[kFTX_LDPC_Nm[m][i] - 1];
-        }
-        if (x != 0)
-        {
-            ++errors;
-        }
+        errors += ldpc_check_parity(codeword, m);
     }
     return errors;
 }
 
-void bp_decode(float codeword[], int max_iters, uint8_t plain[], int* ok)
+void bp_decode(float codeword[], int max_iters, uint64_t plain[], int* ok)
 {
     float tov[FTX_LDPC_N][3];
-    float toc[FTX_LDPC_M][7];
+    float toc[FTX_LDPC_NUM_EDGES];
+    uint8_t hard[LDPC_HARD_BYTES] = { 0 };
 
     int min_errors = FTX_LDPC_M;
 
@@ -143,14 +241,13 @@ void bp_decode(float codeword[], int max_iters, uint8_t plain[], int* ok)
     for (int iter = 0; iter < max_iters; ++iter)
     {
         // Do a hard decision guess (tov=0 in iter 0)
-        int plain_sum = 0;
         for (int n = 0; n < FTX_LDPC_N; ++n)
         {
-            plain[n] = ((codeword[n] + tov[n][0] + tov[n][1] + tov[n][2]) > 0) ? 1 : 0;
-            plain_sum += plain[n];
+            hard[n] = ((codeword[n] + tov[n][0] + tov[n][1] + tov[n][2]) > 0) ? 1 : 0;
         }
+        ldpc_pack(hard, plain);
 
-        if (plain_sum == 0)
+        if (ldpc_is_zero(plain, FTX_LDPC_N_WORDS))
         {
             // message converged to all-zeros, which is prohibited
             break;
@@ -171,44 +268,505 @@ void bp_decode(float codeword[], int max_iters, uint8_t plain[], int* ok)
         }
 
         // Send messages from bits to check nodes
-        for (int m = 0; m < FTX_LDPC_M; ++m)
+        for (int e = 0; e < FTX_LDPC_NUM_EDGES; ++e)
+        {
+            int n = kFTX_LDPC_Edge_bit[e];
+            int m_idx = kFTX_LDPC_Edge_slot[e] - 3 * n;
+            // for each (n, m): the messages from the two other check nodes of the bit, in order
+            float Tnm = codeword[n] + tov[n][(m_idx == 0) ? 1 : 0] + tov[n][(m_idx == 2) ? 1 : 2];
+            toc[e] = fast_tanh(-Tnm / 2);
+        }
+
+        // send messages from check nodes to variable nodes
+        for (int n = 0; n < FTX_LDPC_N; ++n)
         {
-            for (int n_idx = 0; n_idx < kFTX_LDPC_Num_rows[m]; ++n_idx)
+            for (int m_idx = 0; m_idx < 3; ++m_idx)
             {
-                int n = kFTX_LDPC_Nm[m][n_idx] - 1;
-                // for each (n, m)
-                float Tnm = codeword[n];
-                for (int m_idx = 0; m_idx < 3; ++m_idx)
+                int m = kFTX_LDPC_Bit_check[n][m_idx];
+                int e_nm = kFTX_LDPC_Bit_edge[n][m_idx];
+                // for each (n, m): the messages from the other bits of the check node, before and after this one
+                float Tmn = 1.0f;
+                for (int e = kFTX_LDPC_Check_offset[m]; e < e_nm; ++e)
                 {
-                    if ((kFTX_LDPC_Mn[n][m_idx] - 1) != m)
-                    {
-                        Tnm += tov[n][m_idx];
-                    }
+                    Tmn *= toc[e];
+                }
+                for (int e = e_nm + 1; e < kFTX_LDPC_Check_offset[m + 1]; ++e)
+                {
+                    Tmn *= toc[e];
                 }
-                toc[m][n_idx] = fast_tanh(-Tnm / 2);
+                tov[n][m_idx] = -2 * fast_atanh(Tmn);
             }
         }
+    }
 
-        // send messages from check nodes to variable nodes
+    *ok = min_errors;
+}
+
+// Min-sum messages are fixed point log-likelihoods, log(P(x=0) / P(x=1)) * MIN_SUM_SCALE
+#define MIN_SUM_SCALE 16
+// Largest magnitude of a quantized input log-likelihood
+#define MIN_SUM_MAX_INPUT 2047
+
+static inline int16_t sat16(int x)
+{
+    return (x > INT16_MAX) ? INT16_MAX : ((x < INT16_MIN) ? INT16_MIN : (int16_t)x);
+}
+
+// Quantize log(P(x=1) / P(x=0)) to the fixed point log(P(x=0) / P(x=1)) of the min-sum decoders
+static void min_sum_quantize(const float codeword[], int16_t llr[])
+{
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+    {
+        float x = -codeword[n] * MIN_SUM_SCALE;
+        x = (x > MIN_SUM_MAX_INPUT) ? MIN_SUM_MAX_INPUT : ((x < -MIN_SUM_MAX_INPUT) ? -MIN_SUM_MAX_INPUT : x);
+        llr[n] = (int16_t)lrintf(x);
+    }
+}
+
+// Vector of 8 lanes of 16-bit fixed point messages
+#if defined(__SSE2__)
+typedef __m128i lanes_t;
+
+static inline lanes_t lanes_set1(int16_t x) { return _mm_set1_epi16(x); }
+static inline lanes_t lanes_adds(lanes_t a, lanes_t b) { return _mm_adds_epi16(a, b); }
+static inline lanes_t lanes_subs(lanes_t a, lanes_t b) { return _mm_subs_epi16(a, b); }
+static inline lanes_t lanes_xor(lanes_t a, lanes_t b) { return _mm_xor_si128(a, b); }
+static inline lanes_t lanes_min(lanes_t a, lanes_t b) { return _mm_min_epi16(a, b); }
+static inline lanes_t lanes_max(lanes_t a, lanes_t b) { return _mm_max_epi16(a, b); }
+static inline lanes_t lanes_abs(lanes_t a) { return _mm_max_epi16(a, _mm_subs_epi16(_mm_setzero_si128(), a)); }
+static inline lanes_t lanes_sign(lanes_t a) { return _mm_srai_epi16(a, 15); }
+static inline lanes_t lanes_scale(lanes_t a) { return _mm_sub_epi16(a, _mm_srai_epi16(a, 2)); }
+static inline lanes_t lanes_select_eq(lanes_t a, lanes_t b, lanes_t if_eq, lanes_t if_ne)
+{
+    __m128i eq = _mm_cmpeq_epi16(a, b);
+    return _mm_or_si128(_mm_and_si128(eq, if_eq), _mm_andnot_si128(eq, if_ne));
+}
+static inline lanes_t lanes_negate(lanes_t a, lanes_t sign) { return _mm_sub_epi16(_mm_xor_si128(a, sign), sign); }
+static inline lanes_t lanes_load(const int16_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+static inline void lanes_store(int16_t* p, lanes_t a) { _mm_storeu_si128((__m128i*)p, a); }
+#elif defined(__ARM_NEON)
+typedef int16x8_t lanes_t;
+
+static inline lanes_t lanes_set1(int16_t x) { return vdupq_n_s16(x); }
+static inline lanes_t lanes_adds(lanes_t a, lanes_t b) { return vqaddq_s16(a, b); }
+static inline lanes_t lanes_subs(lanes_t a, lanes_t b) { return vqsubq_s16(a, b); }
+static inline lanes_t lanes_xor(lanes_t a, lanes_t b) { return veorq_s16(a, b); }
+static inline lanes_t lanes_min(lanes_t a, lanes_t b) { return vminq_s16(a, b); }
+static inline lanes_t lanes_max(lanes_t a, lanes_t b) { return vmaxq_s16(a, b); }
+static inline lanes_t lanes_abs(lanes_t a) { return vqabsq_s16(a); }
+static inline lanes_t lanes_sign(lanes_t a) { return vshrq_n_s16(a, 15); }
+static inline lanes_t lanes_scale(lanes_t a) { return vsubq_s16(a, vshrq_n_s16(a, 2)); }
+static inline lanes_t lanes_select_eq(lanes_t a, lanes_t b, lanes_t if_eq, lanes_t if_ne) { return vbslq_s16(vceqq_s16(a, b), if_eq, if_ne); }
+static inline lanes_t lanes_negate(lanes_t a, lanes_t sign) { return vsubq_s16(veorq_s16(a, sign), sign); }
+static inline lanes_t lanes_load(const int16_t* p) { return vld1q_s16(p); }
+static inline void lanes_store(int16_t* p, lanes_t a) { vst1q_s16(p, a); }
+#else
+typedef struct
+{
+    int16_t x[8];
+} lanes_t;
+
+#define LANES_MAP(expr)             \
+    lanes_t r;                      \
+    for (int i = 0; i < 8; ++i)     \
+        r.x[i] = (int16_t)(expr);   \
+    return r
+
+static inline lanes_t lanes_set1(int16_t x) { LANES_MAP(x); }
+static inline lanes_t lanes_adds(lanes_t a, lanes_t b) { LANES_MAP(sat16(a.x[i] + b.x[i])); }
+static inline lanes_t lanes_subs(lanes_t a, lanes_t b) { LANES_MAP(sat16(a.x[i] - b.x[i])); }
+static inline lanes_t lanes_xor(lanes_t a, lanes_t b) { LANES_MAP(a.x[i] ^ b.x[i]); }
+static inline lanes_t lanes_min(lanes_t a, lanes_t b) { LANES_MAP((a.x[i] < b.x[i]) ? a.x[i] : b.x[i]); }
+static inline lanes_t lanes_max(lanes_t a, lanes_t b) { LANES_MAP((a.x[i] > b.x[i]) ? a.x[i] : b.x[i]); }
+static inline lanes_t lanes_abs(lanes_t a) { LANES_MAP(sat16((a.x[i] < 0) ? -a.x[i] : a.x[i])); }
+static inline lanes_t lanes_sign(lanes_t a) { LANES_MAP((a.x[i] < 0) ? -1 : 0); }
+static inline lanes_t lanes_scale(lanes_t a) { LANES_MAP(a.x[i] - (a.x[i] >> 2)); }
+static inline lanes_t lanes_select_eq(lanes_t a, lanes_t b, lanes_t if_eq, lanes_t if_ne) { LANES_MAP((a.x[i] == b.x[i]) ? if_eq.x[i] : if_ne.x[i]); }
+static inline lanes_t lanes_negate(lanes_t a, lanes_t sign) { LANES_MAP(sign.x[i] ? -a.x[i] : a.x[i]); }
+static inline lanes_t lanes_load(const int16_t* p) { LANES_MAP(p[i]); }
+static inline void lanes_store(int16_t* p, lanes_t a)
+{
+    for (int i = 0; i < 8; ++i)
+        p[i] = a.x[i];
+}
+#endif
+
+// Normalized min-sum update of one check node in each lane: the message to each bit is the product of the signs
+// times the smallest magnitude of the messages from the other bits, scaled by 3/4
+static inline void min_sum_check_lanes(const lanes_t toc[], lanes_t tov[], int num_rows)
+{
+    lanes_t min1 = lanes_set1(INT16_MAX);
+    lanes_t min2 = min1;
+    lanes_t parity = lanes_set1(0);
+    lanes_t mag[7];
+    for (int k = 0; k < num_rows; ++k)
+    {
+        parity = lanes_xor(parity, toc[k]);
+        mag[k] = lanes_abs(toc[k]);
+        min2 = lanes_min(min2, lanes_max(min1, mag[k]));
+        min1 = lanes_min(min1, mag[k]);
+    }
+    lanes_t out1 = lanes_scale(min1);
+    lanes_t out2 = lanes_scale(min2);
+    for (int k = 0; k < num_rows; ++k)
+    {
+        // The bit with the smallest magnitude gets the second smallest, the sign is that of the product of the others
+        lanes_t out = lanes_select_eq(mag[k], min1, out2, out1);
+        tov[k] = lanes_negate(out, lanes_sign(lanes_xor(parity, toc[k])));
+    }
+}
+
+// Check node update of all check nodes, one vector lane per check node.
+// The messages to the missing 7th bit of the check nodes with 6 bits and the padding check nodes hold INT16_MAX.
+static void min_sum_check_update(const int16_t toc[7][FTX_LDPC_M_PADDED], int16_t tov[7][FTX_LDPC_M_PADDED])
+{
+    for (int m = 0; m < FTX_LDPC_M_PADDED; m += 8)
+    {
+        lanes_t toc_m[7];
+        lanes_t tov_m[7];
+        for (int k = 0; k < 7; ++k)
+        {
+            toc_m[k] = lanes_load(&toc[k][m]);
+        }
+        min_sum_check_lanes(toc_m, tov_m, 7);
+        for (int k = 0; k < 7; ++k)
+        {
+            lanes_store(&tov[k][m], tov_m[k]);
+        }
+    }
+}
+
+void min_sum_decode(float codeword[], int max_iters, uint64_t plain[], int* ok)
+{
+    // Messages between bits and check nodes, by check node: toc[k][m] from the k-th bit of check node m,
+    // tov[k][m] to the k-th bit of check node m
+    int16_t toc[7][FTX_LDPC_M_PADDED];
+    int16_t tov[7][FTX_LDPC_M_PADDED];
+    int16_t llr[FTX_LDPC_N];
+    int total[FTX_LDPC_N];
+    uint8_t hard[LDPC_HARD_BYTES] = { 0 };
+
+    int min_errors = FTX_LDPC_M;
+
+    min_sum_quantize(codeword, llr);
+    for (int k = 0; k < 7; ++k)
+    {
+        for (int m = 0; m < FTX_LDPC_M_PADDED; ++m)
+        {
+            toc[k][m] = INT16_MAX;
+            tov[k][m] = 0;
+        }
+    }
+
+    for (int iter = 0; iter < max_iters; ++iter)
+    {
+        // Beliefs of the bits and hard decision
         for (int n = 0; n < FTX_LDPC_N; ++n)
         {
-            for (int m_idx = 0; m_idx < 3; ++m_idx)
+            total[n] = llr[n];
+        }
+        for (int m = 0; m < FTX_LDPC_M; ++m)
+        {
+            const uint8_t* bits = &kFTX_LDPC_Edge_bit[kFTX_LDPC_Check_offset[m]];
+            const int num_rows = kFTX_LDPC_Check_offset[m + 1] - kFTX_LDPC_Check_offset[m];
+            for (int k = 0; k < num_rows; ++k)
             {
-                int m = kFTX_LDPC_Mn[n][m_idx] - 1;
-                // for each (n, m)
-                float Tmn = 1.0f;
-                for (int n_idx = 0; n_idx < kFTX_LDPC_Num_rows[m]; ++n_idx)
+                total[bits[k]] += tov[k][m];
+            }
+        }
+        for (int n = 0; n < FTX_LDPC_N; ++n)
+        {
+            hard[n] = (total[n] < 0) ? 1 : 0;
+        }
+        ldpc_pack(hard, plain);
+
+        if (ldpc_is_zero(plain, FTX_LDPC_N_WORDS))
+        {
+            // message converged to all-zeros, which is prohibited
+            break;
+        }
+
+        int errors = ldpc_check(plain);
+
+        if (errors < min_errors)
+        {
+            // we have a better guess - update the result
+            min_errors = errors;
+
+            if (errors == 0)
+            {
+                break; // Found a perfect answer
+            }
+        }
+
+        // Messages from bits to check nodes (excluding the message from the same check node)
+        for (int m = 0; m < FTX_LDPC_M; ++m)
+        {
+            const uint8_t* bits = &kFTX_LDPC_Edge_bit[kFTX_LDPC_Check_offset[m]];
+            const int num_rows = kFTX_LDPC_Check_offset[m + 1] - kFTX_LDPC_Check_offset[m];
+            for (int k = 0; k < num_rows; ++k)
+            {
+                toc[k][m] = sat16(total[bits[k]] - tov[k][m]);
+            }
+        }
+
+        min_sum_check_update(toc, tov);
+    }
+
+    *ok = min_errors;
+}
+
+// Vectors of lanes in a batch
+#define MIN_SUM_BATCH_VECTORS (FTX_LDPC_BATCH / 8)
+
+void min_sum_decode_batch(float codeword[][FTX_LDPC_N], int num_codewords, int max_iters, uint64_t plain[][FTX_LDPC_N_WORDS], int ok[])
+{
+    // Structure of arrays, the innermost index is the codeword (lane), otherwise the same as min_sum_decode()
+    lanes_t llr[FTX_LDPC_N][MIN_SUM_BATCH_VECTORS];
+    lanes_t total[FTX_LDPC_N][MIN_SUM_BATCH_VECTORS];
+    lanes_t tov[FTX_LDPC_NUM_EDGES][MIN_SUM_BATCH_VECTORS];
+    int min_errors[FTX_LDPC_BATCH];
+    bool active[FTX_LDPC_BATCH];
+
+    int num_active = 0;
+    for (int v = 0; v < MIN_SUM_BATCH_VECTORS; ++v)
+    {
+        int16_t x[8][FTX_LDPC_N];
+        for (int i = 0; i < 8; ++i)
+        {
+            int l = v * 8 + i;
+            if (l < num_codewords)
+            {
+                min_sum_quantize(codeword[l], x[i]);
+            }
+            else
+            {
+                // Unused lanes decide on all zeros and end right away
+                memset(x[i], 0, sizeof(x[i]));
+            }
+            min_errors[l] = FTX_LDPC_M;
+            active[l] = (l < num_codewords);
+            num_active += active[l];
+        }
+        for (int n = 0; n < FTX_LDPC_N; ++n)
+        {
+            int16_t lanes[8];
+            for (int i = 0; i < 8; ++i)
+            {
+                lanes[i] = x[i][n];
+            }
+            llr[n][v] = lanes_load(lanes);
+        }
+        for (int e = 0; e < FTX_LDPC_NUM_EDGES; ++e)
+        {
+            tov[e][v] = lanes_set1(0);
+        }
+    }
+
+    for (int iter = 0; (iter < max_iters) && (num_active > 0); ++iter)
+    {
+        // Beliefs of the bits. Unlike in min_sum_decode() the sums saturate to 16 bits, but the sign is kept:
+        // a sum can only saturate on the second or third of the three messages of a bit, and each message is
+        // smaller than 3/4 * INT16_MAX.
+        memcpy(total, llr, sizeof(total));
+        for (int e = 0; e < FTX_LDPC_NUM_EDGES; ++e)
+        {
+            lanes_t* total_n = total[kFTX_LDPC_Edge_bit[e]];
+            for (int v = 0; v < MIN_SUM_BATCH_VECTORS; ++v)
+            {
+                total_n[v] = lanes_adds(total_n[v], tov[e][v]);
+            }
+        }
+
+        // Number of ones in the hard decision and of failed parity checks in each lane
+        int16_t plain_sum[FTX_LDPC_BATCH];
+        int16_t errors[FTX_LDPC_BATCH];
+        for (int v = 0; v < MIN_SUM_BATCH_VECTORS; ++v)
+        {
+            lanes_t sum = lanes_set1(0);
+            for (int n = 0; n < FTX_LDPC_N; ++n)
+            {
+                sum = lanes_subs(sum, lanes_sign(total[n][v]));
+            }
+            lanes_t num_errors = lanes_set1(0);
+            for (int m = 0; m < FTX_LDPC_M; ++m)
+            {
+                lanes_t parity = lanes_set1(0);
+                for (int e = kFTX_LDPC_Check_offset[m]; e < kFTX_LDPC_Check_offset[m + 1]; ++e)
+                {
+                    parity = lanes_xor(parity, total[kFTX_LDPC_Edge_bit[e]][v]);
+                }
+                num_errors = lanes_subs(num_errors, lanes_sign(parity));
+            }
+            lanes_store(&plain_sum[v * 8], sum);
+            lanes_store(&errors[v * 8], num_errors);
+        }
+
+        // Lanes that have converged (or run out of iterations) keep their result, the others go on
+        for (int l = 0; l < FTX_LDPC_BATCH; ++l)
+        {
+            if (!active[l])
+                continue;
+            bool done = (plain_sum[l] == 0);
+            if (!done && (errors[l] < min_errors[l]))
+            {
+                min_errors[l] = errors[l];
+                done = (errors[l] == 0);
+            }
+            if (done || (iter == max_iters - 1))
+            {
+                uint8_t hard[LDPC_HARD_BYTES] = { 0 };
+                for (int n = 0; n < FTX_LDPC_N; ++n)
+                {
+                    int16_t lanes[8];
+                    lanes_store(lanes, total[n][l / 8]);
+                    hard[n] = (lanes[l % 8] < 0) ? 1 : 0;
+                }
+                ldpc_pack(hard, plain[l]);
+            }
+            if (done)
+            {
+                active[l] = false;
+                --num_active;
+            }
+        }
+        if (num_active == 0)
+        {
+            break;
+        }
+
+        // Check node updates, one check node at a time for all the lanes
+        for (int m = 0; m < FTX_LDPC_M; ++m)
+        {
+            const int e0 = kFTX_LDPC_Check_offset[m];
+            const int num_rows = kFTX_LDPC_Check_offset[m + 1] - e0;
+            for (int v = 0; v < MIN_SUM_BATCH_VECTORS; ++v)
+            {
+                lanes_t toc[7];
+                lanes_t tov_m[7];
+                for (int k = 0; k < num_rows; ++k)
+                {
+                    toc[k] = lanes_subs(total[kFTX_LDPC_Edge_bit[e0 + k]][v], tov[e0 + k][v]);
+                }
+                min_sum_check_lanes(toc, tov_m, num_rows);
+                for (int k = 0; k < num_rows; ++k)
+                {
+                    tov[e0 + k][v] = tov_m[k];
+                }
+            }
+        }
+    }
+
+    for (int l = 0; l < num_codewords; ++l)
+    {
+        ok[l] = min_errors[l];
+    }
+}
+
+void layered_decode(float codeword[], int max_iters, uint64_t plain[], int* ok)
+{
+    int16_t tov[FTX_LDPC_NUM_EDGES]; // Messages from check nodes to their bits
+    int16_t llr[FTX_LDPC_N];
+    int post[FTX_LDPC_N];      // Posterior log-likelihoods of the bits
+    uint8_t hard[LDPC_HARD_BYTES] = { 0 };
+    uint64_t syndrome[FTX_LDPC_M_WORDS];
+
+    min_sum_quantize(codeword, llr);
+
+    // Hard decision and syndrome of the channel values, afterwards kept up to date as bits flip
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+    {
+        post[n] = llr[n];
+        hard[n] = (post[n] < 0) ? 1 : 0;
+    }
+    ldpc_pack(hard, plain);
+    memset(tov, 0, sizeof(tov));
+    ldpc_syndrome(plain, syndrome);
+
+    int min_errors = FTX_LDPC_M;
+
+    for (int iter = 0; iter < max_iters; ++iter)
+    {
+        if (ldpc_is_zero(plain, FTX_LDPC_N_WORDS))
+        {
+            // message converged to all-zeros, which is prohibited
+            break;
+        }
+
+        int errors = ldpc_syndrome_weight(syndrome);
+
+        if (errors < min_errors)
+        {
+            // we have a better guess - update the result
+            min_errors = errors;
+
+            if (errors == 0)
+            {
+                break; // Found a perfect answer
+            }
+        }
+
+        // Check nodes one at a time, each one updating the posteriors of its bits right away
+        for (int m = 0; m < FTX_LDPC_M; ++m)
+        {
+            const uint8_t* bits = &kFTX_LDPC_Edge_bit[kFTX_LDPC_Check_offset[m]];
+            int16_t* tov_m = &tov[kFTX_LDPC_Check_offset[m]];
+            const int num_rows = kFTX_LDPC_Check_offset[m + 1] - kFTX_LDPC_Check_offset[m];
+            int toc[7];
+            int min1 = INT16_MAX;
+            int min2 = INT16_MAX;
+            int parity = 0;
+            for (int k = 0; k < num_rows; ++k)
+            {
+                // Message from the bit, excluding the previous message from this check node
+                toc[k] = post[bits[k]] - tov_m[k];
+                int mag = (toc[k] < 0) ? -toc[k] : toc[k];
+                mag = (mag > INT16_MAX) ? INT16_MAX : mag;
+                parity ^= toc[k];
+                if (mag < min1)
+                {
+                    min2 = min1;
+                    min1 = mag;
+                }
+                else if (mag < min2)
+                {
+                    min2 = mag;
+                }
+            }
+            const int out1 = min1 - (min1 >> 2);
+            const int out2 = min2 - (min2 >> 2);
+            for (int k = 0; k < num_rows; ++k)
+            {
+                int n = bits[k];
+                int mag = (toc[k] < 0) ? -toc[k] : toc[k];
+                int out = (mag == min1) ? out2 : out1;
+                tov_m[k] = (int16_t)(((parity ^ toc[k]) < 0) ? -out : out);
+                const int prev = post[n];
+                post[n] = toc[k] + tov_m[k];
+
+                if ((prev ^ post[n]) < 0)
                 {
-                    if ((kFTX_LDPC_Nm[m][n_idx] - 1) != n)
+                    // Flip the bit and the parity of its check nodes
+                    plain[n / 64] ^= (uint64_t)1 << LDPC_BIT_SHIFT(n);
+                    for (int w = 0; w < FTX_LDPC_M_WORDS; ++w)
                     {
-                        Tmn *= toc[m][n_idx];
+                        syndrome[w] ^= kFTX_LDPC_Bit_syndrome[n][w];
                     }
                 }
-                tov[n][m_idx] = -2 * fast_atanh(Tmn);
+            }
+
+            if (ldpc_is_zero(syndrome, FTX_LDPC_M_WORDS) && !ldpc_is_zero(plain, FTX_LDPC_N_WORDS))
+            {
+                break; // Valid codeword in the middle of the iteration, no need to finish it
             }
         }
     }
 
+    if (ldpc_is_zero(syndrome, FTX_LDPC_M_WORDS) && !ldpc_is_zero(plain, FTX_LDPC_N_WORDS))
+    {
+        min_errors = 0;
+    }
+
     *ok = min_errors;
 }
 
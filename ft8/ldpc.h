@@ -3,18 +3,38 @@
 
 #include <stdint.h>
 
+#include "constants.h"
+
 #ifdef __cplusplus
 extern "C"
 {
 #endif
 
 // codeword is 174 log-likelihoods.
-// plain is a return value, 174 ints, to be 0 or 1.
+// plain is a return value, 174 bits packed into FTX_LDPC_N_WORDS words starting from the MSB
+// (the order of kFTX_LDPC_Check_mask).
 // iters is how hard to try.
 // ok == 87 means success.
-void ldpc_decode(float codeword[], int max_iters, uint8_t plain[], int* ok);
+void ldpc_decode(float codeword[], int max_iters, uint64_t plain[], int* ok);
+
+void bp_decode(float codeword[], int max_iters, uint64_t plain[], int* ok);
+
+// Same as bp_decode(), with the normalized min-sum approximation of the check node messages,
+// computed in fixed point (16-bit) for all check nodes at once with SIMD instructions where available.
+void min_sum_decode(float codeword[], int max_iters, uint64_t plain[], int* ok);
+
+// Number of codewords decoded at once by min_sum_decode_batch()
+#define FTX_LDPC_BATCH 16
+
+// Same as min_sum_decode() on up to FTX_LDPC_BATCH codewords at once, one per vector lane. All codewords
+// walk the graph together; a codeword that has converged keeps its result while the others go on.
+// The bit beliefs saturate to 16 bits, otherwise the results are those of min_sum_decode() on each codeword.
+void min_sum_decode_batch(float codeword[][FTX_LDPC_N], int num_codewords, int max_iters, uint64_t plain[][FTX_LDPC_N_WORDS], int ok[]);
 
-void bp_decode(float codeword[], int max_iters, uint8_t plain[], int* ok);
+// Same as min_sum_decode(), with a layered schedule: the check nodes are processed one after another,
+// each one updating the posteriors of its bits before the next one, and the syndrome is tracked
+// incrementally so that decoding stops as soon as the hard decision is a codeword.
+void layered_decode(float codeword[], int max_iters, uint64_t plain[], int* ok);
 
 #ifdef __cplusplus
 }
@@ -8,9 +8,14 @@
 #include "ft8/text.h"
 #include "ft8/encode.h"
 #include "ft8/constants.h"
+#include "ft8/ldpc.h"
 
 #include "fft/kiss_fftr.h"
 #include "common/common.h"
+#include "common/monitor.h"
+#include "common/tracker.h"
+#include "common/dt_estimator.h"
+#include "common/channelizer.h"
 #include "ft8/message.h"
 
 #define LOG_LEVEL LOG_INFO
@@ -232,6 +237,1668 @@ void test_msg(const char* message_text, ftx_message_type_t expected_type, const
     TEST_END;
 }
 
+// Scalar waterfall magnitude conversion, as originally done in monitor_process()
+static uint8_t quantize_reference(const kiss_fft_cpx* x)
+{
+    float mag2 = (x->i * x->i) + (x->r * x->r);
+    float db = 10.0f * log10f(1E-12f + mag2);
+    int scaled = (int)(2 * db + 240);
+    return (scaled < 0) ? 0 : ((scaled > 255) ? 255 : scaled);
+}
+
+void test_quantize_mag(void)
+{
+    enum { kNum_probes = 256 * 320 + 5 };
+    static kiss_fft_cpx bins[kNum_probes];
+    static uint8_t mag[kNum_probes];
+    int num_bins = 0;
+
+    // For every output code, probe amplitudes straddling its lower edge (found by bisection
+    // of the reference conversion) as well as a spread of amplitudes inside its range
+    float amp_prev = 0;
+    for (int code = 1; code <= 256; ++code)
+    {
+        // Smallest amplitude that converts to 'code' (code 256 stands for the top of the probed range)
+        float lo = 0, hi = 8.0f;
+        while (code < 256)
+        {
+            float mid = (lo + hi) / 2;
+            if (mid <= lo || mid >= hi)
+                break;
+            kiss_fft_cpx x = { mid, 0 };
+            if (quantize_reference(&x) >= code)
+                hi = mid;
+            else
+                lo = mid;
+        }
+        for (int i = 0; i < 64; ++i)
+        {
+            float amp = amp_prev + (hi - amp_prev) * (i + 0.5f) / 64;
+            bins[num_bins++] = (kiss_fft_cpx){ amp * 0.6f, amp * 0.8f };
+        }
+        if (code == 256)
+            break;
+        float amp = hi;
+        for (int i = 0; i < 128; ++i)
+            amp = nextafterf(amp, 0);
+        for (int i = 0; i < 256; ++i)
+        {
+            bins[num_bins++] = (kiss_fft_cpx){ amp, 0 };
+            amp = nextafterf(amp, 8.0f);
+        }
+        amp_prev = hi;
+    }
+    bins[num_bins++] = (kiss_fft_cpx){ 0, 0 };
+    bins[num_bins++] = (kiss_fft_cpx){ 1000.0f, -1000.0f };
+
+    float max_power = 0;
+    for (int i = 0; i < num_bins; ++i)
+    {
+        float power = 1E-12f + ((bins[i].i * bins[i].i) + (bins[i].r * bins[i].r));
+        if (power > max_power)
+            max_power = power;
+    }
+
+    // Start at odd offsets to exercise the scalar tail of the SIMD kernels as well
+    for (int start = 0; start < 3; ++start)
+    {
+        float result_max = monitor_quantize_mag(bins + start, num_bins - start, mag);
+        CHECK(result_max == max_power);
+
+        bool seen[256] = { false };
+        int num_mismatches = 0;
+        for (int i = start; i < num_bins; ++i)
+        {
+            uint8_t expected = quantize_reference(&bins[i]);
+            seen[expected] = true;
+            if (mag[i - start] != expected)
+                ++num_mismatches;
+        }
+        CHECK_EQ_VAL(num_mismatches, 0);
+        for (int code = 0; code < 256; ++code)
+        {
+            CHECK(seen[code]);
+        }
+    }
+    printf("Quantized %d waterfall bins covering all 256 codes\n", num_bins);
+    TEST_END;
+}
+
+void test_monitor_mem(void)
+{
+    monitor_config_t mon_cfg = {
+        .f_min = 200,
+        .f_max = 3000,
+        .sample_rate = 12000,
+        .time_osr = 2,
+        .freq_osr = 2,
+        .protocol = FTX_PROTOCOL_FT8
+    };
+
+    // Query the size, then check that a block that is one byte short is rejected
+    monitor_t mon_arena;
+    size_t lenmem = 0;
+    CHECK(!monitor_init_mem(&mon_arena, &mon_cfg, NULL, &lenmem));
+    CHECK(lenmem > 0);
+    char* arena = (char*)malloc(lenmem + 1);
+    size_t lenmem_short = lenmem - 1;
+    CHECK(!monitor_init_mem(&mon_arena, &mon_cfg, arena + 1, &lenmem_short));
+    // Deliberately misaligned block start
+    CHECK(monitor_init_mem(&mon_arena, &mon_cfg, arena + 1, &lenmem));
+    CHECK(mon_arena.mem == NULL);
+    bool mag_aligned = ((uintptr_t)mon_arena.wf.mag % MONITOR_MEM_ALIGN) == 0;
+    CHECK(mag_aligned);
+
+    monitor_t mon_heap;
+    monitor_init(&mon_heap, &mon_cfg);
+
+    // Both monitors must produce the same waterfall for a test tone
+    float frame[mon_heap.block_size];
+    for (int block = 0; block < mon_heap.wf.max_blocks; ++block)
+    {
+        for (int i = 0; i < mon_heap.block_size; ++i)
+        {
+            frame[i] = 0.1f * sinf(2 * (float)M_PI * 1000.0f * (block * mon_heap.block_size + i) / 12000);
+        }
+        monitor_process(&mon_heap, frame);
+        monitor_process(&mon_arena, frame);
+    }
+    CHECK_EQ_VAL(mon_arena.wf.num_blocks, mon_heap.wf.num_blocks);
+    int wf_size = mon_heap.wf.num_blocks * mon_heap.wf.block_stride;
+    CHECK_EQ_VAL(0, memcmp(mon_arena.wf.mag, mon_heap.wf.mag, wf_size));
+
+    monitor_free(&mon_heap);
+    monitor_free(&mon_arena);
+    free(arena);
+    printf("Monitor memory block: %zu bytes\n", lenmem);
+    TEST_END;
+}
+
+void test_monitor_multi(void)
+{
+    monitor_config_t mon_cfg = {
+        .f_min = 200,
+        .f_max = 3000,
+        .sample_rate = 12000,
+        .time_osr = 2,
+        .freq_osr = 2,
+        .protocol = FTX_PROTOCOL_FT8
+    };
+    // Five channels: one group of four through the batched FFT and one channel on the regular path
+    enum { num_channels = 5 };
+
+    monitor_multi_t multi;
+    monitor_multi_init(&multi, &mon_cfg, num_channels);
+    monitor_t single[num_channels];
+    for (int ch = 0; ch < num_channels; ++ch)
+    {
+        monitor_init(&single[ch], &mon_cfg);
+    }
+    CHECK(multi.channels[1].window == multi.channels[0].window);
+    CHECK(multi.channels[1].wf.mag != multi.channels[0].wf.mag);
+
+    // A different tone and noise on every channel, fed as interleaved samples
+    const int block_size = multi.block_size;
+    float interleaved[block_size * num_channels];
+    float frame[num_channels][block_size];
+    uint32_t seed = 1;
+    for (int block = 0; block < single[0].wf.max_blocks; ++block)
+    {
+        for (int i = 0; i < block_size; ++i)
+        {
+            for (int ch = 0; ch < num_channels; ++ch)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                float noise = 0.01f * ((int32_t)seed / 2147483648.0f);
+                float tone = 0.1f * sinf(2 * (float)M_PI * (500.0f + 300.0f * ch) * (block * block_size + i) / 12000);
+                frame[ch][i] = tone + noise;
+                interleaved[i * num_channels + ch] = frame[ch][i];
+            }
+        }
+        monitor_multi_process_interleaved(&multi, interleaved);
+        for (int ch = 0; ch < num_channels; ++ch)
+        {
+            monitor_process(&single[ch], frame[ch]);
+        }
+    }
+
+    int wf_size = single[0].wf.num_blocks * single[0].wf.block_stride;
+    for (int ch = 0; ch < num_channels; ++ch)
+    {
+        CHECK_EQ_VAL(multi.channels[ch].wf.num_blocks, single[ch].wf.num_blocks);
+        CHECK_EQ_VAL(0, memcmp(multi.channels[ch].wf.mag, single[ch].wf.mag, wf_size));
+        monitor_free(&single[ch]);
+    }
+    monitor_multi_free(&multi);
+    TEST_END;
+}
+
+// Add a continuous phase FT8 signal to a real or complex (IQ) stream, starting 0.5 s after start_time
+static void add_ft8(float* signal, int num_samples, int sample_rate, float start_time, double freq, const char* text, bool iq)
+{
+    ftx_message_t msg;
+    uint8_t tones[FT8_NN];
+    ftx_message_encode(&msg, &hash_if, text);
+    ft8_encode(msg.payload, tones);
+
+    const int start = (int)((start_time + 0.5f) * sample_rate);
+    const int samples_per_symbol = (int)(sample_rate * FT8_SYMBOL_PERIOD);
+    double phase = 0;
+    for (int i = 0; i < FT8_NN * samples_per_symbol && start + i < num_samples; ++i)
+    {
+        phase += 2 * M_PI * (freq + tones[i / samples_per_symbol] / FT8_SYMBOL_PERIOD) / sample_rate;
+        if (iq)
+        {
+            signal[2 * (start + i)] += 0.1f * (float)cos(phase);
+            signal[2 * (start + i) + 1] += 0.1f * (float)sin(phase);
+        }
+        else
+        {
+            signal[start + i] += 0.1f * (float)cos(phase);
+        }
+    }
+}
+
+// Decode all distinct messages in a waterfall, along with the candidates they were found at
+static int decode_waterfall(const ftx_waterfall_t* wf, char texts[][FTX_MAX_MESSAGE_LENGTH], ftx_candidate_t* found, int max_found)
+{
+    ftx_candidate_t candidates[50];
+    int num_candidates = ftx_find_candidates(wf, 50, candidates, 10);
+    int num_found = 0;
+    for (int idx = 0; idx < num_candidates && num_found < max_found; ++idx)
+    {
+        ftx_message_t message;
+        ftx_decode_status_t status;
+        if (!ftx_decode_candidate(wf, &candidates[idx], 25, &message, &status))
+            continue;
+        ftx_message_offsets_t offsets;
+        if (ftx_message_decode(&message, &hash_if, texts[num_found], &offsets) != FTX_MESSAGE_RC_OK)
+            continue;
+        bool is_new = true;
+        for (int prev = 0; prev < num_found; ++prev)
+        {
+            if (0 == strcmp(texts[prev], texts[num_found]))
+                is_new = false;
+        }
+        if (is_new)
+        {
+            found[num_found] = candidates[idx];
+            ++num_found;
+        }
+    }
+    return num_found;
+}
+
+// Return true if the waterfall decodes to exactly the expected message
+static bool decode_single(const ftx_waterfall_t* wf, const char* expected)
+{
+    char texts[4][FTX_MAX_MESSAGE_LENGTH];
+    ftx_candidate_t found[4];
+    int num_found = decode_waterfall(wf, texts, found, 4);
+    return (num_found == 1) && (0 == strcmp(texts[0], expected));
+}
+
+void test_channelizer(void)
+{
+    channelizer_config_t cfg = {
+        .sample_rate = 192000,
+        .center_freq = 14100000,
+        .f_min = 100,
+        .f_max = 3000,
+        .time_osr = 2,
+        .freq_osr = 2
+    };
+    double dials[4];
+    CHECK_EQ_VAL(1, channelizer_find_dials(FTX_PROTOCOL_FT8, &cfg, dials, 4));
+    CHECK(dials[0] == 14074000.0);
+    CHECK_EQ_VAL(1, channelizer_find_dials(FTX_PROTOCOL_FT4, &cfg, dials + 1, 3));
+    CHECK(dials[1] == 14080000.0);
+
+    // One signal in each USB sub-band, and one just below the first dial frequency (the opposite sideband)
+    const int num_samples = 15 * cfg.sample_rate;
+    float* iq = (float*)calloc(2 * num_samples, sizeof(float));
+    uint32_t seed = 1;
+    for (int i = 0; i < 2 * num_samples; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        iq[i] = 0.001f * ((int32_t)seed / 2147483648.0f);
+    }
+    add_ft8(iq, num_samples, cfg.sample_rate, 0, dials[0] + 1200 - cfg.center_freq, "CQ K1ABC FN42", true);
+    add_ft8(iq, num_samples, cfg.sample_rate, 0, dials[0] - 1250 - cfg.center_freq, "CQ W9XYZ EN37", true);
+    add_ft8(iq, num_samples, cfg.sample_rate, 0, dials[1] + 700 - cfg.center_freq, "CQ N0ABC DM79", true);
+
+    // Both sub-bands decoded as FT8, as only the dial frequency matters to the channelizer
+    ftx_protocol_t protocols[2] = { FTX_PROTOCOL_FT8, FTX_PROTOCOL_FT8 };
+    channelizer_t chan;
+    CHECK(channelizer_init(&chan, &cfg, 2, dials, protocols));
+    CHECK_EQ_VAL(12000, chan.audio_rate);
+    // Feed the stream in uneven pieces
+    for (int pos = 0; pos < num_samples; pos += 7777)
+    {
+        int count = (num_samples - pos < 7777) ? (num_samples - pos) : 7777;
+        channelizer_process(&chan, iq + 2 * pos, count);
+    }
+    CHECK_EQ_VAL(chan.slices[0].mon.wf.max_blocks, chan.slices[0].mon.wf.num_blocks);
+    CHECK(decode_single(&chan.slices[0].mon.wf, "CQ K1ABC FN42"));
+    CHECK(decode_single(&chan.slices[1].mon.wf, "CQ N0ABC DM79"));
+    channelizer_free(&chan);
+
+    // Dial frequency outside of the IQ bandwidth
+    double far_dial = 7074000;
+    CHECK(!channelizer_init(&chan, &cfg, 1, &far_dial, protocols));
+
+    free(iq);
+    TEST_END;
+}
+
+void test_monitor_iq(void)
+{
+    const int sample_rate = 12000;
+    const int num_samples = 15 * sample_rate;
+    float* iq = (float*)calloc(2 * num_samples, sizeof(float));
+    uint32_t seed = 1;
+    for (int i = 0; i < 2 * num_samples; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        iq[i] = 0.001f * ((int32_t)seed / 2147483648.0f);
+    }
+    add_ft8(iq, num_samples, sample_rate, 0, -1500, "CQ K1ABC FN42", true);
+    add_ft8(iq, num_samples, sample_rate, 0, 1000, "CQ N0ABC DM79", true);
+
+    // Both engines, with a band covering negative and positive frequencies
+    for (int engine = MONITOR_ENGINE_FFT; engine <= MONITOR_ENGINE_SDFT; ++engine)
+    {
+        monitor_config_t mon_cfg = {
+            .f_min = -3000,
+            .f_max = 3000,
+            .sample_rate = sample_rate,
+            .time_osr = 2,
+            .freq_osr = 2,
+            .protocol = FTX_PROTOCOL_FT8,
+            .engine = (monitor_engine_t)engine,
+            .iq_input = true
+        };
+        monitor_t mon;
+        monitor_init(&mon, &mon_cfg);
+        CHECK_EQ_VAL(-480, mon.min_bin);
+        monitor_reset(&mon);
+        for (int pos = 0; pos + mon.block_size <= num_samples; pos += mon.block_size)
+        {
+            monitor_process(&mon, iq + 2 * pos);
+        }
+
+        char texts[4][FTX_MAX_MESSAGE_LENGTH];
+        ftx_candidate_t found[4];
+        CHECK_EQ_VAL(2, decode_waterfall(&mon.wf, texts, found, 4));
+        for (int idx = 0; idx < 2; ++idx)
+        {
+            float freq_hz = (mon.min_bin + found[idx].freq_offset + (float)found[idx].freq_sub / mon.wf.freq_osr) / mon.symbol_period;
+            float expected_hz = (0 == strcmp(texts[idx], "CQ K1ABC FN42")) ? -1500.0f : 1000.0f;
+            CHECK(fabsf(freq_hz - expected_hz) < 4.0f);
+        }
+        monitor_free(&mon);
+    }
+
+    free(iq);
+    TEST_END;
+}
+
+void test_monitor_sdft(void)
+{
+    const int sample_rate = 12000;
+    const int num_samples = 15 * sample_rate;
+    float* signal = (float*)calloc(num_samples, sizeof(float));
+    uint32_t seed = 1;
+    for (int i = 0; i < num_samples; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        signal[i] = 0.001f * ((int32_t)seed / 2147483648.0f);
+    }
+    add_ft8(signal, num_samples, sample_rate, 0, 1000, "CQ K1ABC FN42", false);
+    add_ft8(signal, num_samples, sample_rate, 0.3f, 2100, "CQ N0ABC DM79", false);
+
+    monitor_t mon[2];
+    for (int engine = MONITOR_ENGINE_FFT; engine <= MONITOR_ENGINE_SDFT; ++engine)
+    {
+        monitor_config_t mon_cfg = {
+            .f_min = 200,
+            .f_max = 3000,
+            .sample_rate = sample_rate,
+            .time_osr = 2,
+            .freq_osr = 2,
+            .protocol = FTX_PROTOCOL_FT8,
+            .engine = (monitor_engine_t)engine
+        };
+        monitor_init(&mon[engine], &mon_cfg);
+        monitor_reset(&mon[engine]);
+        for (int pos = 0; pos + mon[engine].block_size <= num_samples; pos += mon[engine].block_size)
+        {
+            monitor_process(&mon[engine], signal + pos);
+        }
+    }
+
+    // The sliding DFT computes the same spectrum as the FFT up to rounding: every magnitude agrees
+    // within one quantization step (0.5 dB), and almost all of them agree exactly
+    CHECK_EQ_VAL(mon[MONITOR_ENGINE_FFT].wf.num_blocks, mon[MONITOR_ENGINE_SDFT].wf.num_blocks);
+    CHECK_EQ_VAL(mon[MONITOR_ENGINE_FFT].wf.block_stride, mon[MONITOR_ENGINE_SDFT].wf.block_stride);
+    const int num_cells = mon[MONITOR_ENGINE_FFT].wf.num_blocks * mon[MONITOR_ENGINE_FFT].wf.block_stride;
+    int max_diff = 0;
+    int num_diff = 0;
+    for (int i = 0; i < num_cells; ++i)
+    {
+        int diff = abs(WF_ELEM_MAG_INT(mon[MONITOR_ENGINE_FFT].wf.mag[i]) - WF_ELEM_MAG_INT(mon[MONITOR_ENGINE_SDFT].wf.mag[i]));
+        max_diff = (diff > max_diff) ? diff : max_diff;
+        num_diff += (diff != 0);
+    }
+    CHECK(max_diff <= 1);
+    CHECK(num_diff * 1000 < num_cells);
+
+    // And both decode the same signals
+    for (int engine = MONITOR_ENGINE_FFT; engine <= MONITOR_ENGINE_SDFT; ++engine)
+    {
+        char texts[4][FTX_MAX_MESSAGE_LENGTH];
+        ftx_candidate_t found[4];
+        CHECK_EQ_VAL(2, decode_waterfall(&mon[engine].wf, texts, found, 4));
+        monitor_free(&mon[engine]);
+    }
+
+    free(signal);
+    printf("SDFT vs FFT waterfall: %d of %d magnitudes differ by one step\n", num_diff, num_cells);
+    TEST_END;
+}
+
+void test_monitor_ring(void)
+{
+    monitor_config_t mon_cfg = {
+        .f_min = 200,
+        .f_max = 3000,
+        .sample_rate = 12000,
+        .time_osr = 2,
+        .freq_osr = 2,
+        .protocol = FTX_PROTOCOL_FT8,
+        .ring_slots = 2
+    };
+    // Four slots of audio, with a different message in slots 1, 2 and 3
+    const int num_samples = 4 * 15 * mon_cfg.sample_rate;
+    float* signal = (float*)calloc(num_samples, sizeof(float));
+    add_ft8(signal, num_samples, mon_cfg.sample_rate, 15, 1000, "CQ K1ABC FN42", false);
+    add_ft8(signal, num_samples, mon_cfg.sample_rate, 30, 1500, "CQ N0ABC DM79", false);
+    add_ft8(signal, num_samples, mon_cfg.sample_rate, 45, 800, "CQ W9XYZ EN37", false);
+
+    monitor_t mon;
+    monitor_init(&mon, &mon_cfg);
+    CHECK_EQ_VAL(188, mon.wf.max_blocks);
+    const int slot_blocks = 93;
+    // Slot n starts at 15 * n / 0.16 = 93.75 * n blocks
+    const int slot1 = 93;
+    const int slot2 = 187;
+    const int slot3 = 281;
+
+    int pos = 0;
+    for (; pos + mon.block_size <= 45 * mon_cfg.sample_rate; pos += mon.block_size)
+    {
+        monitor_process(&mon, signal + pos);
+    }
+    CHECK_EQ_VAL(281, mon.wf.block_count);
+    // The default view holds the most recent blocks
+    CHECK_EQ_VAL(281 - 188, mon.wf.block_start);
+    CHECK_EQ_VAL(188, mon.wf.num_blocks);
+
+    CHECK_EQ_VAL(slot_blocks, ftx_waterfall_set_view(&mon.wf, slot1, slot_blocks));
+    CHECK(decode_single(&mon.wf, "CQ K1ABC FN42"));
+    CHECK_EQ_VAL(slot_blocks, ftx_waterfall_set_view(&mon.wf, slot2, slot_blocks));
+    CHECK(decode_single(&mon.wf, "CQ N0ABC DM79"));
+
+    // Keep going without a reset: the view extends to the newest block, and old blocks get overwritten
+    for (; pos + mon.block_size <= num_samples; pos += mon.block_size)
+    {
+        monitor_process(&mon, signal + pos);
+    }
+    CHECK_EQ_VAL(375, mon.wf.block_count);
+    CHECK_EQ_VAL(375 - 188, mon.wf.block_start);
+    CHECK_EQ_VAL(slot_blocks, ftx_waterfall_set_view(&mon.wf, slot3, slot_blocks));
+    CHECK(decode_single(&mon.wf, "CQ W9XYZ EN37"));
+    // Slot 1 is gone, the view is clamped to slot 2, which now wraps around the end of the ring
+    ftx_waterfall_set_view(&mon.wf, slot1, slot_blocks);
+    CHECK_EQ_VAL(375 - 188, mon.wf.block_start);
+    CHECK(decode_single(&mon.wf, "CQ N0ABC DM79"));
+
+    monitor_free(&mon);
+    free(signal);
+    TEST_END;
+}
+
+void test_waterfall_layout(void)
+{
+    monitor_config_t mon_cfg = {
+        .f_min = 200,
+        .f_max = 3000,
+        .sample_rate = 12000,
+        .time_osr = 2,
+        .freq_osr = 2,
+        .protocol = FTX_PROTOCOL_FT8,
+        .ring_slots = 2
+    };
+    const int num_samples = 3 * 15 * mon_cfg.sample_rate;
+    float* signal = (float*)calloc(num_samples, sizeof(float));
+    add_ft8(signal, num_samples, mon_cfg.sample_rate, 0, 1000, "CQ K1ABC FN42", false);
+    add_ft8(signal, num_samples, mon_cfg.sample_rate, 30, 1500, "CQ N0ABC DM79", false);
+
+    monitor_t mon_blocks, mon_planes;
+    monitor_init(&mon_blocks, &mon_cfg);
+    mon_cfg.wf_layout = FTX_WATERFALL_LAYOUT_PLANES;
+    monitor_init(&mon_planes, &mon_cfg);
+    CHECK_EQ_VAL(FTX_WATERFALL_LAYOUT_BLOCKS, mon_blocks.wf.layout);
+    CHECK_EQ_VAL(FTX_WATERFALL_LAYOUT_PLANES, mon_planes.wf.layout);
+    // Consecutive blocks of a subdivision are adjacent rows in the planes layout
+    CHECK_EQ_VAL(mon_planes.wf.num_bins, (int)(ftx_waterfall_row(&mon_planes.wf, 1, 1, 1) - ftx_waterfall_row(&mon_planes.wf, 0, 1, 1)));
+
+    for (int pos = 0; pos + mon_blocks.block_size <= num_samples; pos += mon_blocks.block_size)
+    {
+        monitor_process(&mon_blocks, signal + pos);
+        monitor_process(&mon_planes, signal + pos);
+    }
+
+    // Same magnitudes, only stored in a different order
+    bool same_rows = true;
+    for (int block = 0; block < mon_blocks.wf.max_blocks; ++block)
+    {
+        for (int time_sub = 0; time_sub < mon_cfg.time_osr; ++time_sub)
+        {
+            for (int freq_sub = 0; freq_sub < mon_cfg.freq_osr; ++freq_sub)
+            {
+                const WF_ELEM_T* row_blocks = ftx_waterfall_row(&mon_blocks.wf, block, time_sub, freq_sub);
+                const WF_ELEM_T* row_planes = ftx_waterfall_row(&mon_planes.wf, block, time_sub, freq_sub);
+                if (0 != memcmp(row_blocks, row_planes, mon_blocks.wf.num_bins * sizeof(WF_ELEM_T)))
+                    same_rows = false;
+            }
+        }
+    }
+    CHECK(same_rows);
+
+    // Slot 0 is gone, slot 1 is contiguous and slot 2 wraps around the end of the ring
+    const int slot_starts[] = { 93, 187 };
+    for (int idx = 0; idx < 2; ++idx)
+    {
+        ftx_waterfall_set_view(&mon_blocks.wf, slot_starts[idx], 93);
+        ftx_waterfall_set_view(&mon_planes.wf, slot_starts[idx], 93);
+        ftx_candidate_t cand_blocks[50], cand_planes[50];
+        int num_blocks = ftx_find_candidates(&mon_blocks.wf, 50, cand_blocks, 10);
+        int num_planes = ftx_find_candidates(&mon_planes.wf, 50, cand_planes, 10);
+        CHECK_EQ_VAL(num_blocks, num_planes);
+        CHECK_EQ_VAL(0, memcmp(cand_blocks, cand_planes, num_blocks * sizeof(ftx_candidate_t)));
+    }
+    CHECK(decode_single(&mon_planes.wf, "CQ N0ABC DM79"));
+
+    monitor_free(&mon_blocks);
+    monitor_free(&mon_planes);
+    free(signal);
+    TEST_END;
+}
+
+void test_waterfall_compact(void)
+{
+    monitor_config_t mon_cfg = {
+        .f_min = 200,
+        .f_max = 3000,
+        .sample_rate = 12000,
+        .time_osr = 2,
+        .freq_osr = 2,
+        .protocol = FTX_PROTOCOL_FT8,
+        .ring_slots = 2
+    };
+    const int num_samples = 3 * 15 * mon_cfg.sample_rate;
+    float* signal = (float*)calloc(num_samples, sizeof(float));
+    add_ft8(signal, num_samples, mon_cfg.sample_rate, 15, 1000, "CQ K1ABC FN42", false);
+    add_ft8(signal, num_samples, mon_cfg.sample_rate, 30, 1503, "CQ N0ABC DM79", false);
+    // The compact format relies on a noise floor (here the SNR is about +10 dB in 2500 Hz)
+    srand(1);
+    for (int i = 0; i < num_samples; ++i)
+    {
+        // Approximately Gaussian noise (sum of 12 uniform samples)
+        float noise = -6.0f;
+        for (int k = 0; k < 12; ++k)
+        {
+            noise += (float)rand() / RAND_MAX;
+        }
+        signal[i] += 0.03f * noise;
+    }
+
+    monitor_t mon, mon_u8;
+    monitor_init(&mon_u8, &mon_cfg);
+    mon_cfg.wf_format = FTX_WATERFALL_FORMAT_U4;
+    monitor_init(&mon, &mon_cfg);
+    CHECK_EQ_VAL(FTX_WATERFALL_FORMAT_U4, mon.wf.format);
+    // Half the size of a uint8_t waterfall (plus a base code per row)
+    CHECK_EQ_VAL(1 + (mon.wf.num_bins + 1) / 2, mon.wf.row_stride);
+    CHECK_EQ_VAL(mon_cfg.time_osr * mon_cfg.freq_osr * mon.wf.row_stride, mon.wf.block_stride);
+    CHECK_EQ_VAL(mon_u8.wf.num_bins, mon_u8.wf.row_stride);
+
+    for (int pos = 0; pos + mon.block_size <= num_samples; pos += mon.block_size)
+    {
+        monitor_process(&mon, signal + pos);
+        monitor_process(&mon_u8, signal + pos);
+    }
+
+    // Slot 1 is contiguous, slot 2 wraps around the end of the ring; both formats decode the same messages
+    CHECK_EQ_VAL(93, ftx_waterfall_set_view(&mon.wf, 93, 93));
+    CHECK_EQ_VAL(93, ftx_waterfall_set_view(&mon_u8.wf, 93, 93));
+    CHECK(decode_single(&mon.wf, "CQ K1ABC FN42"));
+    CHECK(decode_single(&mon_u8.wf, "CQ K1ABC FN42"));
+    CHECK_EQ_VAL(93, ftx_waterfall_set_view(&mon.wf, 187, 93));
+    CHECK_EQ_VAL(93, ftx_waterfall_set_view(&mon_u8.wf, 187, 93));
+    CHECK(decode_single(&mon.wf, "CQ N0ABC DM79"));
+    CHECK(decode_single(&mon_u8.wf, "CQ N0ABC DM79"));
+
+    // The strongest candidate is found at the frequency of the signal, at the same place as with uint8_t magnitudes
+    ftx_candidate_t candidates[10];
+    ftx_candidate_t candidates_u8[10];
+    int num_candidates = ftx_find_candidates(&mon.wf, 10, candidates, 10);
+    CHECK(num_candidates > 0);
+    CHECK(ftx_find_candidates(&mon_u8.wf, 10, candidates_u8, 10) > 0);
+    float freq = (mon.min_bin + candidates[0].freq_offset + (float)candidates[0].freq_sub / mon_cfg.freq_osr) / mon.symbol_period;
+    CHECK(fabsf(freq - 1503) < 3.2f);
+    CHECK_EQ_VAL(candidates_u8[0].time_offset, candidates[0].time_offset);
+    CHECK_EQ_VAL(candidates_u8[0].time_sub, candidates[0].time_sub);
+    CHECK_EQ_VAL(candidates_u8[0].freq_offset, candidates[0].freq_offset);
+    CHECK_EQ_VAL(candidates_u8[0].freq_sub, candidates[0].freq_sub);
+
+    monitor_free(&mon);
+    monitor_free(&mon_u8);
+    free(signal);
+    TEST_END;
+}
+
+// Straightforward sync score of a candidate (see ftx_find_candidates())
+static int reference_sync_score(const ftx_waterfall_t* wf, const ftx_candidate_t* cand)
+{
+    const bool is_ft4 = (wf->protocol == FTX_PROTOCOL_FT4);
+    const int num_sync = is_ft4 ? FT4_NUM_SYNC : FT8_NUM_SYNC;
+    const int length_sync = is_ft4 ? FT4_LENGTH_SYNC : FT8_LENGTH_SYNC;
+    const int sync_offset = is_ft4 ? FT4_SYNC_OFFSET : FT8_SYNC_OFFSET;
+    const int last_tone = is_ft4 ? 3 : 7;
+    int score = 0;
+    int num_average = 0;
+    for (int m = 0; m < num_sync; ++m)
+    {
+        for (int k = 0; k < length_sync; ++k)
+        {
+            int block = cand->time_offset + (is_ft4 ? 1 : 0) + sync_offset * m + k;
+            if (block < 0)
+                continue;
+            if (block >= wf->num_blocks)
+                break;
+            int sm = is_ft4 ? kFT4_Costas_pattern[m][k] : kFT8_Costas_pattern[k];
+            int index = (wf->block_start + block) % wf->max_blocks;
+            int index_prev = (wf->block_start + block + wf->max_blocks - 1) % wf->max_blocks;
+            int index_next = (wf->block_start + block + 1) % wf->max_blocks;
+            const uint8_t* p = ftx_waterfall_row(wf, index, cand->time_sub, cand->freq_sub) + cand->freq_offset;
+            const uint8_t* p_prev = ftx_waterfall_row(wf, index_prev, cand->time_sub, cand->freq_sub) + cand->freq_offset;
+            const uint8_t* p_next = ftx_waterfall_row(wf, index_next, cand->time_sub, cand->freq_sub) + cand->freq_offset;
+            // Neighbours are only read when they are used, the tone below sm == 0 may lie before the row
+            if (sm > 0)
+            {
+                score += p[sm] - p[sm - 1];
+                ++num_average;
+            }
+            if (sm < last_tone)
+            {
+                score += p[sm] - p[sm + 1];
+                ++num_average;
+            }
+            if ((k > 0) && (block > 0))
+            {
+                score += p[sm] - p_prev[sm];
+                ++num_average;
+            }
+            if ((k + 1 < length_sync) && (block + 1 < wf->num_blocks))
+            {
+                score += p[sm] - p_next[sm];
+                ++num_average;
+            }
+        }
+    }
+    return (num_average > 0) ? (score / num_average) : 0;
+}
+
+// Unique index of a candidate searched by ftx_find_candidates() (time offsets -10 .. 19)
+static int candidate_index(const ftx_waterfall_t* wf, const ftx_candidate_t* cand)
+{
+    int index = (cand->time_sub * wf->freq_osr) + cand->freq_sub;
+    index = (index * 30) + (cand->time_offset + 10);
+    return (index * wf->num_bins) + cand->freq_offset;
+}
+
+static bool same_candidates(const ftx_candidate_t* a, const ftx_candidate_t* b, int num)
+{
+    for (int idx = 0; idx < num; ++idx)
+    {
+        if ((a[idx].score != b[idx].score) || (a[idx].time_offset != b[idx].time_offset) || (a[idx].freq_offset != b[idx].freq_offset) ||
+            (a[idx].time_sub != b[idx].time_sub) || (a[idx].freq_sub != b[idx].freq_sub))
+            return false;
+    }
+    return true;
+}
+
+// Waterfall of 120 blocks (60 bins, 2x2 oversampling) with random magnitudes, seen from block 200 of a ring buffer.
+// Any byte is valid in both formats, so the caller picks the format and the strides; wf->mag is released with free().
+static void random_waterfall(ftx_waterfall_t* wf, unsigned seed)
+{
+    *wf = (ftx_waterfall_t){
+        .max_blocks = 120,
+        .num_bins = 60,
+        .time_osr = 2,
+        .freq_osr = 2,
+        .layout = FTX_WATERFALL_LAYOUT_BLOCKS
+    };
+    const int size = wf->max_blocks * wf->time_osr * wf->freq_osr * wf->num_bins + FTX_WATERFALL_U4_PADDING;
+    wf->mag = (uint8_t*)malloc(size);
+    srand(seed);
+    for (int i = 0; i < size; ++i)
+    {
+        wf->mag[i] = rand() & 0xFF;
+    }
+    wf->block_count = 200;
+}
+
+void test_find_candidates(void)
+{
+    // Random magnitudes in a ring buffer, with a view that wraps around its end.
+    // 60 bins are not a multiple of the vector width, so some offsets are scored one by one.
+    ftx_waterfall_t wf = {
+        .max_blocks = 120,
+        .num_bins = 60,
+        .time_osr = 2,
+        .freq_osr = 2,
+        .row_stride = 60,
+        .block_stride = 2 * 2 * 60,
+        .layout = FTX_WATERFALL_LAYOUT_BLOCKS,
+        .format = FTX_WATERFALL_FORMAT_U8
+    };
+    wf.mag = (uint8_t*)malloc(wf.max_blocks * wf.block_stride);
+    srand(2);
+    for (int i = 0; i < wf.max_blocks * wf.block_stride; ++i)
+    {
+        wf.mag[i] = rand() & 0xFF;
+    }
+    wf.block_count = 200;
+    const int max_candidates = wf.time_osr * wf.freq_osr * 30 * wf.num_bins;
+    ftx_candidate_t* heap = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    bool* found = (bool*)malloc(max_candidates);
+    ftx_candidate_t* heap_parallel = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    const int min_scores[] = { -3, 0, 2 };
+    const ftx_protocol_t protocols[] = { FTX_PROTOCOL_FT8, FTX_PROTOCOL_FT4 };
+    for (int idx_protocol = 0; idx_protocol < 2; ++idx_protocol)
+    {
+        wf.protocol = protocols[idx_protocol];
+        const int num_tones = (wf.protocol == FTX_PROTOCOL_FT4) ? 4 : 8;
+        const int view_starts[] = { 80, 90 };
+        for (int idx_view = 0; idx_view < 2; ++idx_view)
+        {
+            ftx_waterfall_set_view(&wf, view_starts[idx_view], (wf.protocol == FTX_PROTOCOL_FT4) ? 100 : 93);
+            for (int idx_score = 0; idx_score < 3; ++idx_score)
+            {
+                // Either all passing candidates fit in the heap, or only the best ones
+                const int min_score = min_scores[idx_score];
+                const int max_found = (idx_view == 0) ? max_candidates : 300;
+                int num_found = ftx_find_candidates(&wf, max_found, heap, min_score);
+
+                // Every candidate has its reference score, and no candidate left out scores higher than those found
+                bool scores_ok = true;
+                memset(found, 0, max_candidates);
+                for (int idx = 0; idx < num_found; ++idx)
+                {
+                    if (heap[idx].score != reference_sync_score(&wf, &heap[idx]))
+                        scores_ok = false;
+                    found[candidate_index(&wf, &heap[idx])] = true;
+                }
+                int num_passing = 0;
+                int max_left_out = -1000;
+                ftx_candidate_t cand;
+                for (cand.time_sub = 0; cand.time_sub < wf.time_osr; ++cand.time_sub)
+                {
+                    for (cand.freq_sub = 0; cand.freq_sub < wf.freq_osr; ++cand.freq_sub)
+                    {
+                        for (cand.time_offset = -10; cand.time_offset < 20; ++cand.time_offset)
+                        {
+                            for (cand.freq_offset = 0; cand.freq_offset + num_tones <= wf.num_bins; ++cand.freq_offset)
+                            {
+                                int score = reference_sync_score(&wf, &cand);
+                                if (score < min_score)
+                                    continue;
+                                ++num_passing;
+                                if (!found[candidate_index(&wf, &cand)] && (score > max_left_out))
+                                    max_left_out = score;
+                            }
+                        }
+                    }
+                }
+                CHECK(scores_ok);
+                CHECK_EQ_VAL((num_passing < max_found) ? num_passing : max_found, num_found);
+                CHECK(num_found == 0 || max_left_out <= heap[num_found - 1].score);
+
+                // The parallel search gives the same candidates in the same order, with any number of threads
+                const int thread_counts[] = { 2, 3, 7, FTX_MAX_THREADS };
+                for (int idx_threads = 0; idx_threads < 4; ++idx_threads)
+                {
+                    void* mem = malloc(ftx_find_candidates_parallel_size(thread_counts[idx_threads], max_found));
+                    int num_found_parallel = ftx_find_candidates_parallel(&wf, thread_counts[idx_threads], mem, max_found, heap_parallel, min_score);
+                    free(mem);
+                    CHECK_EQ_VAL(num_found, num_found_parallel);
+                    CHECK(same_candidates(heap, heap_parallel, num_found));
+                }
+            }
+        }
+    }
+    free(heap_parallel);
+    free(found);
+    free(heap);
+    free(wf.mag);
+    TEST_END;
+}
+
+void test_sync_planes(void)
+{
+    // Random magnitudes in a ring buffer (uint8_t or compact rows, where any byte is valid)
+    ftx_waterfall_t wf;
+    random_waterfall(&wf, 3);
+    const int max_candidates = wf.time_osr * wf.freq_osr * 30 * wf.num_bins;
+    ftx_candidate_t* heap = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    ftx_candidate_t* heap_planes = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    const ftx_protocol_t protocols[] = { FTX_PROTOCOL_FT8, FTX_PROTOCOL_FT4 };
+    for (int idx_protocol = 0; idx_protocol < 2; ++idx_protocol)
+    {
+        wf.protocol = protocols[idx_protocol];
+        void* planes_mem = malloc(ftx_sync_planes_size(&wf));
+        CHECK(planes_mem != NULL);
+        for (int format = FTX_WATERFALL_FORMAT_U8; format <= FTX_WATERFALL_FORMAT_U4; ++format)
+        {
+            wf.format = (ftx_waterfall_format_t)format;
+            wf.layout = (wf.format == FTX_WATERFALL_FORMAT_U4) ? FTX_WATERFALL_LAYOUT_PLANES : FTX_WATERFALL_LAYOUT_BLOCKS;
+            wf.row_stride = (wf.format == FTX_WATERFALL_FORMAT_U4) ? FTX_WATERFALL_U4_ROW_SIZE(wf.num_bins) : wf.num_bins;
+            wf.block_stride = wf.time_osr * wf.freq_osr * wf.row_stride;
+            // Contiguous view, view wrapping around the end of the ring and a short view
+            const int view_starts[] = { 80, 90, 150 };
+            const int view_lengths[] = { 93, 100, 40 };
+            for (int idx_view = 0; idx_view < 3; ++idx_view)
+            {
+                ftx_waterfall_set_view(&wf, view_starts[idx_view], view_lengths[idx_view]);
+                ftx_sync_planes_t planes;
+                ftx_sync_planes_build(&planes, &wf, planes_mem);
+                CHECK_EQ_VAL((wf.protocol == FTX_PROTOCOL_FT4) ? 9 : 4, planes.num_planes);
+
+                // Same candidates in the same order, with all passing candidates or only the best ones
+                const int max_found[] = { max_candidates, 300 };
+                for (int idx_found = 0; idx_found < 2; ++idx_found)
+                {
+                    int num_found = ftx_find_candidates(&wf, max_found[idx_found], heap, 0);
+                    CHECK_EQ_VAL(num_found, ftx_find_candidates_planes(&planes, max_found[idx_found], heap_planes, 0));
+                    CHECK(same_candidates(heap, heap_planes, num_found));
+                }
+
+                // Single scores, including those below the threshold
+                int num_found = ftx_find_candidates(&wf, max_candidates, heap, -1000);
+                bool scores_ok = true;
+                for (int idx = 0; idx < num_found; ++idx)
+                {
+                    if (ftx_sync_planes_score(&planes, &heap[idx]) != heap[idx].score)
+                        scores_ok = false;
+                    if ((wf.format == FTX_WATERFALL_FORMAT_U8) && (reference_sync_score(&wf, &heap[idx]) != heap[idx].score))
+                        scores_ok = false;
+                }
+                CHECK(scores_ok);
+            }
+        }
+        free(planes_mem);
+    }
+    free(heap_planes);
+    free(heap);
+    free(wf.mag);
+    TEST_END;
+}
+
+static void update_search(void* ctx, const ftx_waterfall_t* wf)
+{
+    ftx_sync_search_update((ftx_sync_search_t*)ctx, wf);
+}
+
+void test_sync_search(void)
+{
+    // Random magnitudes in a ring buffer, blocks of the slot arrive one by one (or a few at a time)
+    ftx_waterfall_t wf;
+    random_waterfall(&wf, 4);
+    const int max_candidates = wf.time_osr * wf.freq_osr * 30 * wf.num_bins;
+    ftx_candidate_t* heap = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    ftx_candidate_t* heap_search = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    const ftx_protocol_t protocols[] = { FTX_PROTOCOL_FT8, FTX_PROTOCOL_FT4 };
+    for (int idx_protocol = 0; idx_protocol < 2; ++idx_protocol)
+    {
+        wf.protocol = protocols[idx_protocol];
+        void* search_mem = malloc(ftx_sync_search_size(&wf));
+        for (int format = FTX_WATERFALL_FORMAT_U8; format <= FTX_WATERFALL_FORMAT_U4; ++format)
+        {
+            wf.format = (ftx_waterfall_format_t)format;
+            wf.layout = FTX_WATERFALL_LAYOUT_BLOCKS;
+            wf.row_stride = (wf.format == FTX_WATERFALL_FORMAT_U4) ? FTX_WATERFALL_U4_ROW_SIZE(wf.num_bins) : wf.num_bins;
+            wf.block_stride = wf.time_osr * wf.freq_osr * wf.row_stride;
+            // A whole slot wrapping around the end of the ring, a slot cut short, and a whole slot ranked
+            // within a DT window only
+            const int num_arrived[] = { 93, 40, 93 };
+            const int update_steps[] = { 1, 7, 3 };
+            const int windows[][2] = { { -10, 19 }, { -10, 19 }, { -3, 6 } };
+            for (int idx_slot = 0; idx_slot < 3; ++idx_slot)
+            {
+                const int slot_start = 80;
+                ftx_sync_search_t search;
+                ftx_sync_search_init(&search, &wf, search_mem);
+                ftx_sync_search_start(&search, slot_start, 93);
+                for (wf.block_count = slot_start; wf.block_count < slot_start + num_arrived[idx_slot];)
+                {
+                    wf.block_count += update_steps[idx_slot];
+                    if (wf.block_count > slot_start + num_arrived[idx_slot])
+                        wf.block_count = slot_start + num_arrived[idx_slot];
+                    ftx_sync_search_update(&search, &wf);
+                }
+                // A whole slot is done as soon as its last block arrives
+                if (idx_slot == 0)
+                    CHECK_EQ_VAL(93, search.num_done);
+
+                int num_found = ftx_sync_search_candidates(&search, &wf, windows[idx_slot][0], windows[idx_slot][1], 300, heap_search, 0);
+                ftx_waterfall_set_view(&wf, slot_start, num_arrived[idx_slot]);
+                const ftx_search_window_t window = {
+                    .freq_offset_min = 0,
+                    .freq_offset_max = wf.num_bins,
+                    .time_offset_min = windows[idx_slot][0],
+                    .time_offset_max = windows[idx_slot][1]
+                };
+                int num_expected;
+                if (idx_slot < 2)
+                    num_expected = ftx_find_candidates(&wf, 300, heap, 0);
+                else
+                    num_expected = ftx_find_candidates_windows(&wf, &window, 1, 300, heap, 0);
+                CHECK_EQ_VAL(num_expected, num_found);
+                CHECK(same_candidates(heap, heap_search, num_found));
+            }
+        }
+        free(search_mem);
+    }
+
+    // Search of the second slot of a rolling waterfall, updated from the monitor
+    monitor_config_t mon_cfg = {
+        .f_min = 200,
+        .f_max = 3000,
+        .sample_rate = 12000,
+        .time_osr = 2,
+        .freq_osr = 2,
+        .protocol = FTX_PROTOCOL_FT8,
+        .ring_slots = 2
+    };
+    const int num_samples = 3 * 15 * mon_cfg.sample_rate;
+    float* signal = (float*)calloc(num_samples, sizeof(float));
+    add_ft8(signal, num_samples, mon_cfg.sample_rate, 30, 1500, "CQ N0ABC DM79", false);
+    monitor_t mon;
+    monitor_init(&mon, &mon_cfg);
+    ftx_sync_search_t search;
+    void* search_mem = malloc(ftx_sync_search_size(&mon.wf));
+    ftx_sync_search_init(&search, &mon.wf, search_mem);
+    ftx_sync_search_start(&search, 187, 93);
+    mon.block_callback = update_search;
+    mon.block_callback_ctx = &search;
+    for (int pos = 0; pos + mon.block_size <= num_samples; pos += mon.block_size)
+    {
+        monitor_process(&mon, signal + pos);
+    }
+    int num_found = ftx_sync_search_candidates(&search, &mon.wf, -10, 19, 100, heap_search, 10);
+    CHECK_EQ_VAL(93, ftx_waterfall_set_view(&mon.wf, 187, 93));
+    CHECK_EQ_VAL(ftx_find_candidates(&mon.wf, 100, heap, 10), num_found);
+    CHECK(same_candidates(heap, heap_search, num_found));
+    CHECK(decode_single(&mon.wf, "CQ N0ABC DM79"));
+
+    monitor_free(&mon);
+    free(search_mem);
+    free(signal);
+    free(heap_search);
+    free(heap);
+    free(wf.mag);
+    TEST_END;
+}
+
+void test_find_candidates_bucketed(void)
+{
+    // Random magnitudes (uint8_t or compact rows) in a ring buffer, with a view that wraps around its end
+    ftx_waterfall_t wf;
+    random_waterfall(&wf, 7);
+    const int max_candidates = wf.time_osr * wf.freq_osr * 30 * wf.num_bins;
+    ftx_candidate_t* heap = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    ftx_candidate_t* bucketed = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    bool* found = (bool*)malloc(max_candidates);
+    const ftx_protocol_t protocols[] = { FTX_PROTOCOL_FT8, FTX_PROTOCOL_FT4 };
+    const int num_candidates[] = { 1, 10, 140, 5000 };
+    const int min_scores[] = { -300, 0, 10, 300 };
+    for (int idx_protocol = 0; idx_protocol < 2; ++idx_protocol)
+    {
+        wf.protocol = protocols[idx_protocol];
+        void* mem = malloc(ftx_find_candidates_bucketed_size(&wf));
+        for (int format = FTX_WATERFALL_FORMAT_U8; format <= FTX_WATERFALL_FORMAT_U4; ++format)
+        {
+            wf.format = (ftx_waterfall_format_t)format;
+            wf.row_stride = (wf.format == FTX_WATERFALL_FORMAT_U4) ? FTX_WATERFALL_U4_ROW_SIZE(wf.num_bins) : wf.num_bins;
+            wf.block_stride = wf.time_osr * wf.freq_osr * wf.row_stride;
+            ftx_waterfall_set_view(&wf, 90, 93);
+            for (int idx_num = 0; idx_num < 4; ++idx_num)
+            {
+                for (int idx_min = 0; idx_min < 4; ++idx_min)
+                {
+                    int num_heap = ftx_find_candidates(&wf, num_candidates[idx_num], heap, min_scores[idx_min]);
+                    int num_bucketed = ftx_find_candidates_bucketed(&wf, mem, num_candidates[idx_num], bucketed, min_scores[idx_min]);
+                    CHECK_EQ_VAL(num_heap, num_bucketed);
+                    if (num_heap != num_bucketed)
+                        continue;
+
+                    // Same scores; same candidates above the lowest score; equal scores in the order of the search
+                    bool same = true;
+                    memset(found, 0, max_candidates);
+                    for (int idx = 0; idx < num_heap; ++idx)
+                    {
+                        if (heap[idx].score > heap[num_heap - 1].score)
+                            found[candidate_index(&wf, &heap[idx])] = true;
+                    }
+                    for (int idx = 0; idx < num_bucketed; ++idx)
+                    {
+                        const ftx_candidate_t* cand = &bucketed[idx];
+                        if (cand->score != heap[idx].score)
+                            same = false;
+                        if ((cand->score > heap[num_heap - 1].score) && !found[candidate_index(&wf, cand)])
+                            same = false;
+                        if ((idx > 0) && (cand->score == bucketed[idx - 1].score) && (candidate_index(&wf, cand) < candidate_index(&wf, &bucketed[idx - 1])))
+                            same = false;
+                        if ((wf.format == FTX_WATERFALL_FORMAT_U8) && (cand->score != reference_sync_score(&wf, cand)))
+                            same = false;
+                    }
+                    CHECK(same);
+                }
+            }
+        }
+        free(mem);
+    }
+    free(found);
+    free(bucketed);
+    free(heap);
+    free(wf.mag);
+    TEST_END;
+}
+
+void test_find_candidates_coarse(void)
+{
+    // Random magnitudes (uint8_t or compact rows) in a ring buffer, with a view that wraps around its end
+    ftx_waterfall_t wf;
+    random_waterfall(&wf, 5);
+    const int max_candidates = wf.time_osr * wf.freq_osr * 30 * wf.num_bins;
+    ftx_candidate_t* heap = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    ftx_candidate_t* heap_coarse = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    bool* found = (bool*)malloc(max_candidates);
+    const ftx_protocol_t protocols[] = { FTX_PROTOCOL_FT8, FTX_PROTOCOL_FT4 };
+    for (int idx_protocol = 0; idx_protocol < 2; ++idx_protocol)
+    {
+        wf.protocol = protocols[idx_protocol];
+        for (int format = FTX_WATERFALL_FORMAT_U8; format <= FTX_WATERFALL_FORMAT_U4; ++format)
+        {
+            wf.format = (ftx_waterfall_format_t)format;
+            wf.row_stride = (wf.format == FTX_WATERFALL_FORMAT_U4) ? FTX_WATERFALL_U4_ROW_SIZE(wf.num_bins) : wf.num_bins;
+            wf.block_stride = wf.time_osr * wf.freq_osr * wf.row_stride;
+            ftx_waterfall_set_view(&wf, 90, 93);
+
+            // With every coarse position kept, the fine pass covers all positions of the window:
+            // the same candidates as ftx_find_candidates() within the window
+            const int windows[][2] = { { -10, 19 }, { -3, 6 } };
+            for (int idx_window = 0; idx_window < 2; ++idx_window)
+            {
+                ftx_search_params_t params = {
+                    .time_offset_min = windows[idx_window][0],
+                    .time_offset_max = windows[idx_window][1],
+                    .num_coarse = max_candidates,
+                    .coarse_margin = 1000
+                };
+                int num_found = ftx_find_candidates(&wf, max_candidates, heap, 1);
+                memset(found, 0, max_candidates);
+                int num_in_window = 0;
+                for (int idx = 0; idx < num_found; ++idx)
+                {
+                    if ((heap[idx].time_offset < params.time_offset_min) || (heap[idx].time_offset > params.time_offset_max))
+                        continue;
+                    found[candidate_index(&wf, &heap[idx])] = true;
+                    ++num_in_window;
+                }
+                void* mem = malloc(ftx_find_candidates_coarse_size(&wf, &params));
+                int num_coarse = ftx_find_candidates_coarse(&wf, &params, mem, max_candidates, heap_coarse, 1);
+                free(mem);
+                CHECK_EQ_VAL(num_in_window, num_coarse);
+                bool same = true;
+                for (int idx = 0; idx < num_coarse; ++idx)
+                {
+                    if (!found[candidate_index(&wf, &heap_coarse[idx])])
+                        same = false;
+                    if ((idx > 0) && (heap_coarse[idx].score > heap_coarse[idx - 1].score))
+                        same = false;
+                }
+                CHECK(same);
+            }
+
+            // With a few coarse positions, candidates are near them and have their true score
+            ftx_search_params_t params = { .time_offset_min = -10, .time_offset_max = 19, .num_coarse = 20, .coarse_margin = 2 };
+            void* mem = malloc(ftx_find_candidates_coarse_size(&wf, &params));
+            int num_coarse = ftx_find_candidates_coarse(&wf, &params, mem, 50, heap_coarse, 0);
+            free(mem);
+            CHECK(num_coarse > 0);
+            bool scores_ok = true;
+            for (int idx = 0; idx < num_coarse; ++idx)
+            {
+                if ((wf.format == FTX_WATERFALL_FORMAT_U8) && (heap_coarse[idx].score != reference_sync_score(&wf, &heap_coarse[idx])))
+                    scores_ok = false;
+            }
+            CHECK(scores_ok);
+        }
+    }
+    free(found);
+    free(heap_coarse);
+    free(heap);
+    free(wf.mag);
+    TEST_END;
+}
+
+void test_find_candidates_windows(void)
+{
+    // Random magnitudes (uint8_t or compact rows) in a ring buffer, with a view that wraps around its end
+    ftx_waterfall_t wf;
+    random_waterfall(&wf, 9);
+    const int max_candidates = wf.time_osr * wf.freq_osr * 30 * wf.num_bins;
+    ftx_candidate_t* heap = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    ftx_candidate_t* heap_windows = (ftx_candidate_t*)malloc(max_candidates * sizeof(ftx_candidate_t));
+    bool* found = (bool*)malloc(max_candidates);
+    // Overlapping windows, one of them beyond the searched time offsets and frequency offsets
+    const ftx_search_window_t windows[] = {
+        { .freq_offset_min = 10, .freq_offset_max = 14, .time_offset_min = -10, .time_offset_max = 19 },
+        { .freq_offset_min = 12, .freq_offset_max = 20, .time_offset_min = 0, .time_offset_max = 5 },
+        { .freq_offset_min = 45, .freq_offset_max = 100, .time_offset_min = 15, .time_offset_max = 40 },
+    };
+    const int num_windows = sizeof(windows) / sizeof(windows[0]);
+    const ftx_protocol_t protocols[] = { FTX_PROTOCOL_FT8, FTX_PROTOCOL_FT4 };
+    for (int idx_protocol = 0; idx_protocol < 2; ++idx_protocol)
+    {
+        wf.protocol = protocols[idx_protocol];
+        for (int format = FTX_WATERFALL_FORMAT_U8; format <= FTX_WATERFALL_FORMAT_U4; ++format)
+        {
+            wf.format = (ftx_waterfall_format_t)format;
+            wf.row_stride = (wf.format == FTX_WATERFALL_FORMAT_U4) ? FTX_WATERFALL_U4_ROW_SIZE(wf.num_bins) : wf.num_bins;
+            wf.block_stride = wf.time_osr * wf.freq_osr * wf.row_stride;
+            ftx_waterfall_set_view(&wf, 90, 93);
+
+            // Same candidates as ftx_find_candidates() within the windows
+            int num_found = ftx_find_candidates(&wf, max_candidates, heap, 0);
+            memset(found, 0, max_candidates);
+            int num_in_windows = 0;
+            for (int idx = 0; idx < num_found; ++idx)
+            {
+                bool inside = false;
+                for (int idx_window = 0; idx_window < num_windows; ++idx_window)
+                {
+                    const ftx_search_window_t* window = &windows[idx_window];
+                    if ((heap[idx].freq_offset >= window->freq_offset_min) && (heap[idx].freq_offset <= window->freq_offset_max) &&
+                        (heap[idx].time_offset >= window->time_offset_min) && (heap[idx].time_offset <= window->time_offset_max))
+                        inside = true;
+                }
+                if (inside)
+                {
+                    found[candidate_index(&wf, &heap[idx])] = true;
+                    ++num_in_windows;
+                }
+            }
+            int num_windows_found = ftx_find_candidates_windows(&wf, windows, num_windows, max_candidates, heap_windows, 0);
+            CHECK_EQ_VAL(num_in_windows, num_windows_found);
+            bool same = true;
+            for (int idx = 0; idx < num_windows_found; ++idx)
+            {
+                if (!found[candidate_index(&wf, &heap_windows[idx])])
+                    same = false;
+                found[candidate_index(&wf, &heap_windows[idx])] = false;
+                if ((idx > 0) && (heap_windows[idx].score > heap_windows[idx - 1].score))
+                    same = false;
+                if ((wf.format == FTX_WATERFALL_FORMAT_U8) && (heap_windows[idx].score != reference_sync_score(&wf, &heap_windows[idx])))
+                    same = false;
+            }
+            CHECK(same);
+
+            // The best candidates of the windows
+            const int num_best = 10;
+            CHECK_EQ_VAL(num_best, ftx_find_candidates_windows(&wf, windows, num_windows, num_best, heap, 0));
+            CHECK_EQ_VAL(heap_windows[num_best - 1].score, heap[num_best - 1].score);
+        }
+    }
+    free(found);
+    free(heap_windows);
+    free(heap);
+    free(wf.mag);
+    TEST_END;
+}
+
+void test_prune_candidates(void)
+{
+    ftx_waterfall_t wf = { .time_osr = 2, .freq_osr = 2 };
+    // score, time_offset, freq_offset, time_sub, freq_sub
+    const ftx_candidate_t candidates[] = {
+        { 50, 5, 100, 0, 0 },
+        { 48, 5, 100, 1, 1 }, // next to the first one (1 subdivision in time and frequency)
+        { 45, 5, 101, 0, 0 }, // 2 frequency subdivisions away
+        { 40, 20, 100, 0, 0 },
+        { 35, 4, 99, 1, 1 }, // 1 subdivision before the first one in time and frequency
+        { 30, 20, 101, 0, 0 },
+    };
+    const int num_candidates = sizeof(candidates) / sizeof(candidates[0]);
+    ftx_candidate_t pruned[sizeof(candidates) / sizeof(candidates[0])];
+
+    memcpy(pruned, candidates, sizeof(candidates));
+    CHECK_EQ_VAL(num_candidates, ftx_prune_candidates(&wf, num_candidates, pruned, 0, 0));
+
+    memcpy(pruned, candidates, sizeof(candidates));
+    CHECK_EQ_VAL(4, ftx_prune_candidates(&wf, num_candidates, pruned, 1, 1));
+    CHECK(same_candidates(&pruned[0], &candidates[0], 1));
+    CHECK(same_candidates(&pruned[1], &candidates[2], 1));
+    CHECK(same_candidates(&pruned[2], &candidates[3], 1));
+    CHECK(same_candidates(&pruned[3], &candidates[5], 1));
+
+    memcpy(pruned, candidates, sizeof(candidates));
+    CHECK_EQ_VAL(2, ftx_prune_candidates(&wf, num_candidates, pruned, 1, 2));
+    CHECK(same_candidates(&pruned[0], &candidates[0], 1));
+    CHECK(same_candidates(&pruned[1], &candidates[3], 1));
+
+    // A time radius only suppresses candidates at the same frequency
+    memcpy(pruned, candidates, sizeof(candidates));
+    CHECK_EQ_VAL(4, ftx_prune_candidates(&wf, num_candidates, pruned, 100, 0));
+    TEST_END;
+}
+
+void test_tracker(void)
+{
+    tracker_t tracker;
+    // Size query, then a block provided by the caller
+    size_t lenmem = 0;
+    CHECK(!tracker_init_mem(&tracker, 3, 2, NULL, &lenmem));
+    CHECK_EQ_VAL((int)(3 * sizeof(tracker_entry_t)), (int)lenmem);
+    tracker_entry_t entries[3];
+    CHECK(tracker_init_mem(&tracker, 3, 2, entries, &lenmem));
+    CHECK_EQ_VAL(0, tracker.num_entries);
+
+    // The same station in slots of the same parity, another one (same frequency) in the other slots
+    tracker_add(&tracker, 10, FTX_PROTOCOL_FT8, 1000, 0.5f);
+    tracker_add(&tracker, 12, FTX_PROTOCOL_FT8, 1002, 0.6f);
+    CHECK_EQ_VAL(1, tracker.num_entries);
+    CHECK_EQ_VAL(12, entries[0].slot);
+    tracker_add(&tracker, 13, FTX_PROTOCOL_FT8, 1000, 0.5f);
+    tracker_add(&tracker, 13, FTX_PROTOCOL_FT4, 1000, 0.5f);
+    CHECK_EQ_VAL(3, tracker.num_entries);
+    // Full: the oldest entry is replaced
+    tracker_add(&tracker, 14, FTX_PROTOCOL_FT8, 2000, 0.5f);
+    CHECK_EQ_VAL(3, tracker.num_entries);
+    CHECK_EQ_VAL(14, entries[0].slot);
+    CHECK_EQ_VAL(2000, (int)entries[0].freq);
+
+    // A signal decoded in slot 0 (at a slightly different frequency and time) is a candidate in slot 2,
+    // add_ft8() places it 0.5 s after its start time (0.8 s)
+    monitor_config_t mon_cfg = {
+        .f_min = 200,
+        .f_max = 3000,
+        .sample_rate = 12000,
+        .time_osr = 2,
+        .freq_osr = 2,
+        .protocol = FTX_PROTOCOL_FT8
+    };
+    monitor_t mon;
+    monitor_init(&mon, &mon_cfg);
+    const int num_samples = 15 * mon_cfg.sample_rate;
+    float* signal = (float*)calloc(num_samples, sizeof(float));
+    add_ft8(signal, num_samples, mon_cfg.sample_rate, 0.3f, 1203, "CQ K1ABC FN42", false);
+    add_ft8(signal, num_samples, mon_cfg.sample_rate, 0.0f, 2203, "CQ N0ABC DM79", false);
+    for (int pos = 0; pos + mon.block_size <= num_samples; pos += mon.block_size)
+    {
+        monitor_process(&mon, signal + pos);
+    }
+
+    CHECK(tracker_init(&tracker, 10, 2));
+    tracker_add(&tracker, 0, FTX_PROTOCOL_FT8, 1205, 0.9f);
+    tracker_add(&tracker, 0, FTX_PROTOCOL_FT4, 2203, 0.5f);
+    ftx_candidate_t candidates[4];
+    int num_candidates = tracker_candidates(&tracker, &mon, 2, 10, candidates, 4);
+    CHECK_EQ_VAL(1, num_candidates);
+    if (num_candidates == 1)
+    {
+        float freq = (mon.min_bin + candidates[0].freq_offset + (float)candidates[0].freq_sub / mon_cfg.freq_osr) / mon.symbol_period;
+        CHECK(fabsf(freq - 1203) < 3.2f);
+        ftx_message_t message;
+        ftx_decode_status_t status;
+        CHECK(ftx_decode_candidate(&mon.wf, &candidates[0], 25, &message, &status));
+    }
+    // Slots of the other parity, entries too old
+    CHECK_EQ_VAL(0, tracker_candidates(&tracker, &mon, 3, 10, candidates, 4));
+    CHECK_EQ_VAL(0, tracker_candidates(&tracker, &mon, 6, 10, candidates, 4));
+    CHECK_EQ_VAL(0, tracker_candidates(&tracker, &mon, 0, 10, candidates, 4));
+    tracker_free(&tracker);
+
+    // Decoded in a waterfall that started 4 blocks earlier: out of the window until the entry moves with the alignment
+    CHECK(tracker_init(&tracker, 10, 2));
+    tracker_add(&tracker, 0, FTX_PROTOCOL_FT8, 1205, 0.9f + 4 * mon.symbol_period);
+    CHECK_EQ_VAL(0, tracker_candidates(&tracker, &mon, 2, 10, candidates, 4));
+    tracker_shift(&tracker, 4 * mon.symbol_period);
+    CHECK_EQ_VAL(1, tracker_candidates(&tracker, &mon, 2, 10, candidates, 4));
+
+    tracker_free(&tracker);
+    monitor_free(&mon);
+    free(signal);
+    TEST_END;
+}
+
+void test_dt_estimator(void)
+{
+    const dt_estimator_config_t cfg = {
+        .symbol_period = FT8_SYMBOL_PERIOD,
+        .decay = 0.75f,
+        .coverage = 0.98f,
+        .margin = 2,
+        .min_weight = 10,
+        .drop_ratio = 0.5f
+    };
+    dt_estimator_t dt;
+    dt_estimator_init(&dt, &cfg);
+    CHECK_EQ_VAL(-10, dt.time_offset_min);
+    CHECK_EQ_VAL(19, dt.time_offset_max);
+
+    // Not enough decodes yet
+    dt_estimator_add(&dt, 0.5f);
+    dt_estimator_end_slot(&dt);
+    CHECK_EQ_VAL(-10, dt.time_offset_min);
+    CHECK_EQ_VAL(19, dt.time_offset_max);
+
+    // Decodes between 0.35 and 0.65 s (blocks 2 .. 4): the window narrows around them, with the margin
+    for (int slot = 0; slot < 3; ++slot)
+    {
+        for (int idx = 0; idx < 20; ++idx)
+        {
+            dt_estimator_add(&dt, 0.35f + 0.3f * idx / 19);
+        }
+        dt_estimator_end_slot(&dt);
+    }
+    CHECK_EQ_VAL(0, dt.time_offset_min);
+    CHECK_EQ_VAL(6, dt.time_offset_max);
+    CHECK(fabsf(dt.center - 0.56f) < 0.1f);
+    CHECK(!dt.widened);
+
+    // A drop of decodes widens the window for one slot
+    dt_estimator_add(&dt, 0.5f);
+    dt_estimator_end_slot(&dt);
+    CHECK(dt.widened);
+    CHECK_EQ_VAL(-10, dt.time_offset_min);
+    CHECK_EQ_VAL(19, dt.time_offset_max);
+    dt_estimator_add(&dt, 0.5f);
+    dt_estimator_end_slot(&dt);
+    CHECK(!dt.widened);
+    CHECK_EQ_VAL(0, dt.time_offset_min);
+    CHECK_EQ_VAL(6, dt.time_offset_max);
+
+    // Re-centering on 1.2 s moves the decodes 4 blocks later in the waterfall
+    CHECK_EQ_VAL(-4, dt_estimator_recenter(&dt, 1.2f));
+    CHECK_EQ_VAL(4, dt.time_offset_min);
+    CHECK_EQ_VAL(10, dt.time_offset_max);
+    CHECK(fabsf(dt.center - 1.2f) < 0.1f);
+    CHECK_EQ_VAL(0, dt_estimator_recenter(&dt, 1.2f));
+    TEST_END;
+}
+
+// Codeword bits (0/1) of an FT8 message, recovered from the data tones
+static void ft8_codeword(const char* text, uint8_t bits[FTX_LDPC_N])
+{
+    ftx_message_t msg;
+    uint8_t tones[FT8_NN];
+    ftx_message_encode(&msg, &hash_if, text);
+    ft8_encode(msg.payload, tones);
+    int n = 0;
+    for (int i_tone = 0; i_tone < FT8_NN; ++i_tone)
+    {
+        if ((i_tone < 7) || ((i_tone >= 36) && (i_tone < 43)) || (i_tone >= 72))
+            continue;
+        int bits3 = 0;
+        while (kFT8_Gray_map[bits3] != tones[i_tone])
+            ++bits3;
+        bits[n++] = (bits3 >> 2) & 1;
+        bits[n++] = (bits3 >> 1) & 1;
+        bits[n++] = bits3 & 1;
+    }
+}
+
+// Bits of a codeword packed into words, as output by the LDPC decoders
+static void pack_codeword(const uint8_t bits[FTX_LDPC_N], uint64_t words[FTX_LDPC_N_WORDS])
+{
+    memset(words, 0, FTX_LDPC_N_WORDS * sizeof(words[0]));
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+    {
+        words[n / 64] |= (uint64_t)bits[n] << (63 - n % 64);
+    }
+}
+
+// Log-likelihoods log(P(x=1) / P(x=0)) of a BPSK codeword with Gaussian noise of standard deviation sigma
+static void noisy_codeword(const uint8_t bits[FTX_LDPC_N], float sigma, unsigned* seed, float codeword[FTX_LDPC_N])
+{
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+    {
+        float u1 = ((*seed = *seed * 1103515245u + 12345u) >> 8 & 0xFFFF) / 65536.0f + 1e-6f;
+        float u2 = ((*seed = *seed * 1103515245u + 12345u) >> 8 & 0xFFFF) / 65536.0f;
+        float noise = sigma * sqrtf(-2 * logf(u1)) * cosf(2 * (float)M_PI * u2);
+        float x = (bits[n] ? 1.0f : -1.0f) + noise;
+        codeword[n] = 2 * x / (sigma * sigma);
+    }
+}
+
+void test_ldpc_tables(void)
+{
+    // The edge-indexed tables describe the same graph as Nm and Mn
+    CHECK_EQ_VAL(0, kFTX_LDPC_Check_offset[0]);
+    CHECK_EQ_VAL(FTX_LDPC_NUM_EDGES, kFTX_LDPC_Check_offset[FTX_LDPC_M]);
+    for (int m = 0; m < FTX_LDPC_M; ++m)
+    {
+        CHECK_EQ_VAL(kFTX_LDPC_Num_rows[m], kFTX_LDPC_Check_offset[m + 1] - kFTX_LDPC_Check_offset[m]);
+        for (int k = 0; k < kFTX_LDPC_Num_rows[m]; ++k)
+        {
+            CHECK_EQ_VAL(kFTX_LDPC_Nm[m][k] - 1, kFTX_LDPC_Edge_bit[kFTX_LDPC_Check_offset[m] + k]);
+        }
+    }
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            int e = kFTX_LDPC_Bit_edge[n][j];
+            CHECK_EQ_VAL(kFTX_LDPC_Mn[n][j] - 1, kFTX_LDPC_Bit_check[n][j]);
+            CHECK_EQ_VAL(n, kFTX_LDPC_Edge_bit[e]);
+            CHECK_EQ_VAL(3 * n + j, kFTX_LDPC_Edge_slot[e]);
+            CHECK(e >= kFTX_LDPC_Check_offset[kFTX_LDPC_Bit_check[n][j]]);
+            CHECK(e < kFTX_LDPC_Check_offset[kFTX_LDPC_Bit_check[n][j] + 1]);
+        }
+    }
+
+    // So do the bit-packed rows and bit syndromes
+    for (int m = 0; m < FTX_LDPC_M; ++m)
+    {
+        uint8_t row[FTX_LDPC_N] = { 0 };
+        uint64_t words[FTX_LDPC_N_WORDS];
+        for (int k = 0; k < kFTX_LDPC_Num_rows[m]; ++k)
+        {
+            row[kFTX_LDPC_Nm[m][k] - 1] = 1;
+        }
+        pack_codeword(row, words);
+        CHECK(0 == memcmp(words, kFTX_LDPC_Check_mask[m], sizeof(words)));
+    }
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+    {
+        uint64_t words[FTX_LDPC_M_WORDS] = { 0 };
+        for (int j = 0; j < 3; ++j)
+        {
+            int m = kFTX_LDPC_Mn[n][j] - 1;
+            words[m / 64] |= (uint64_t)1 << (63 - m % 64);
+        }
+        CHECK(0 == memcmp(words, kFTX_LDPC_Bit_syndrome[n], sizeof(words)));
+    }
+    TEST_END;
+}
+
+void test_min_sum_decode(void)
+{
+    uint8_t bits[FTX_LDPC_N];
+    uint64_t packed[FTX_LDPC_N_WORDS];
+    uint64_t plain[FTX_LDPC_N_WORDS];
+    float codeword[FTX_LDPC_N];
+    int ok;
+    ft8_codeword("CQ K7IHZ DM43", bits);
+    pack_codeword(bits, packed);
+
+    // Noiseless codeword decodes in the first iteration
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+        codeword[n] = bits[n] ? 5.0f : -5.0f;
+    min_sum_decode(codeword, 1, plain, &ok);
+    CHECK_EQ_VAL(0, ok);
+    CHECK(0 == memcmp(plain, packed, sizeof(packed)));
+
+    // Noisy codewords with hard decision errors are corrected like bp_decode() does
+    unsigned seed = 1;
+    int num_min_sum = 0, num_bp = 0, num_hard_errors = 0;
+    for (int trial = 0; trial < 20; ++trial)
+    {
+        noisy_codeword(bits, 0.6f, &seed, codeword);
+        for (int n = 0; n < FTX_LDPC_N; ++n)
+            num_hard_errors += ((codeword[n] > 0) != bits[n]);
+        min_sum_decode(codeword, 25, plain, &ok);
+        if (ok == 0 && 0 == memcmp(plain, packed, sizeof(packed)))
+            ++num_min_sum;
+        bp_decode(codeword, 25, plain, &ok);
+        if (ok == 0 && 0 == memcmp(plain, packed, sizeof(packed)))
+            ++num_bp;
+    }
+    CHECK(num_hard_errors > 20 * 5);
+    CHECK_EQ_VAL(20, num_bp);
+    CHECK_EQ_VAL(20, num_min_sum);
+
+    // All-zero decision is rejected
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+        codeword[n] = 0;
+    min_sum_decode(codeword, 25, plain, &ok);
+    CHECK_EQ_VAL(FTX_LDPC_M, ok);
+
+    // Pure noise does not decode
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+        bits[n] = 0;
+    noisy_codeword(bits, 10.0f, &seed, codeword);
+    min_sum_decode(codeword, 25, plain, &ok);
+    CHECK(ok > 0);
+    TEST_END;
+}
+
+void test_layered_decode(void)
+{
+    uint8_t bits[FTX_LDPC_N];
+    uint64_t packed[FTX_LDPC_N_WORDS];
+    uint64_t plain[FTX_LDPC_N_WORDS];
+    float codeword[FTX_LDPC_N];
+    int ok;
+    ft8_codeword("CQ K7IHZ DM43", bits);
+    pack_codeword(bits, packed);
+
+    // Noiseless codeword is accepted before any check node update
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+        codeword[n] = bits[n] ? 5.0f : -5.0f;
+    layered_decode(codeword, 1, plain, &ok);
+    CHECK_EQ_VAL(0, ok);
+    CHECK(0 == memcmp(plain, packed, sizeof(packed)));
+
+    // Noisy codewords decode with fewer iterations than with the flooding schedule
+    unsigned seed = 1;
+    int num_layered = 0, num_bp = 0;
+    for (int trial = 0; trial < 20; ++trial)
+    {
+        noisy_codeword(bits, 0.7f, &seed, codeword);
+        layered_decode(codeword, 3, plain, &ok);
+        if (ok == 0 && 0 == memcmp(plain, packed, sizeof(packed)))
+            ++num_layered;
+        bp_decode(codeword, 3, plain, &ok);
+        if (ok == 0 && 0 == memcmp(plain, packed, sizeof(packed)))
+            ++num_bp;
+    }
+    CHECK(num_layered > num_bp);
+    CHECK(num_layered >= 15);
+
+    // All-zero decision is rejected
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+        codeword[n] = 0;
+    layered_decode(codeword, 25, plain, &ok);
+    CHECK_EQ_VAL(FTX_LDPC_M, ok);
+
+    // Pure noise does not decode
+    for (int n = 0; n < FTX_LDPC_N; ++n)
+        bits[n] = 0;
+    noisy_codeword(bits, 10.0f, &seed, codeword);
+    layered_decode(codeword, 25, plain, &ok);
+    CHECK(ok > 0);
+    TEST_END;
+}
+
+void test_decode_candidates_batch(void)
+{
+    // Codewords of three messages with noise, mixed with pure noise, one lane more than a full batch
+    const char* texts[] = { "CQ K1ABC FN42", "K1ABC W9XYZ EN37", "W9XYZ K1ABC -11" };
+    const int num_codewords = FTX_LDPC_BATCH + 1;
+    float codeword[FTX_LDPC_BATCH + 1][FTX_LDPC_N];
+    uint8_t bits[3][FTX_LDPC_N];
+    uint8_t zeros[FTX_LDPC_N] = { 0 };
+    unsigned seed = 3;
+    for (int i = 0; i < 3; ++i)
+    {
+        ft8_codeword(texts[i], bits[i]);
+    }
+    for (int idx = 0; idx < num_codewords; ++idx)
+    {
+        if (idx % 2 == 0)
+            noisy_codeword(bits[idx % 3], 0.65f, &seed, codeword[idx]);
+        else
+            noisy_codeword(zeros, 10.0f, &seed, codeword[idx]);
+    }
+
+    // Same results as decoding each codeword on its own
+    uint64_t plain[FTX_LDPC_BATCH][FTX_LDPC_N_WORDS];
+    int ok[FTX_LDPC_BATCH];
+    for (int start = 0; start < num_codewords; start += FTX_LDPC_BATCH)
+    {
+        int num_batch = (num_codewords - start < FTX_LDPC_BATCH) ? (num_codewords - start) : FTX_LDPC_BATCH;
+        min_sum_decode_batch(&codeword[start], num_batch, 25, plain, ok);
+        for (int i = 0; i < num_batch; ++i)
+        {
+            uint64_t plain1[FTX_LDPC_N_WORDS];
+            int ok1;
+            min_sum_decode(codeword[start + i], 25, plain1, &ok1);
+            CHECK_EQ_VAL(ok1, ok[i]);
+            CHECK(0 == memcmp(plain1, plain[i], sizeof(plain1)));
+            int expect_ok = ((start + i) % 2 == 0);
+            CHECK_EQ_VAL(expect_ok, (ok[i] == 0));
+        }
+    }
+
+    // All the signals of a waterfall decode from a list of candidates
+    monitor_config_t mon_cfg = {
+        .f_min = 200,
+        .f_max = 3000,
+        .sample_rate = 12000,
+        .time_osr = 2,
+        .freq_osr = 2,
+        .protocol = FTX_PROTOCOL_FT8
+    };
+    monitor_t mon;
+    monitor_init(&mon, &mon_cfg);
+    const int num_samples = 15 * mon_cfg.sample_rate;
+    float* signal = (float*)calloc(num_samples, sizeof(float));
+    for (int i = 0; i < 3; ++i)
+    {
+        add_ft8(signal, num_samples, mon_cfg.sample_rate, 0.1f * i, 600 + 700 * i, texts[i], false);
+    }
+    for (int pos = 0; pos + mon.block_size <= num_samples; pos += mon.block_size)
+    {
+        monitor_process(&mon, signal + pos);
+    }
+    ftx_candidate_t candidates[50];
+    int num_candidates = ftx_find_candidates(&mon.wf, 50, candidates, 10);
+    ftx_message_t messages[50];
+    ftx_decode_status_t status[50];
+    bool decoded[50];
+    int num_decoded = ftx_decode_candidates_batch(&mon.wf, candidates, num_candidates, 25, messages, status, decoded);
+    int num_found[3] = { 0 };
+    for (int idx = 0; idx < num_candidates; ++idx)
+    {
+        if (!decoded[idx])
+        {
+            CHECK((status[idx].ldpc_errors > 0) || (status[idx].crc_calculated != status[idx].crc_extracted));
+            continue;
+        }
+        --num_decoded;
+        char text[FTX_MAX_MESSAGE_LENGTH];
+        ftx_message_offsets_t offsets;
+        CHECK_EQ_VAL(FTX_MESSAGE_RC_OK, ftx_message_decode(&messages[idx], &hash_if, text, &offsets));
+        for (int i = 0; i < 3; ++i)
+        {
+            if (0 == strcmp(text, texts[i]))
+                ++num_found[i];
+        }
+    }
+    CHECK_EQ_VAL(0, num_decoded);
+    CHECK(num_found[0] > 0 && num_found[1] > 0 && num_found[2] > 0);
+
+    monitor_free(&mon);
+    free(signal);
+    TEST_END;
+}
+
 #define SIZEOF_ARRAY(x) (sizeof(x) / sizeof((x)[0]))
 
 int main()
@@ -282,5 +1949,28 @@ int main()
     test_msg("CQ 123 LB2JK JO59", FTX_MESSAGE_TYPE_STANDARD,
              "CQ 123 LB2JK JO59", &hash_if);
 
+    test_quantize_mag();
+    test_monitor_mem();
+    test_monitor_multi();
+    test_channelizer();
+    test_monitor_iq();
+    test_monitor_sdft();
+    test_monitor_ring();
+    test_waterfall_layout();
+    test_waterfall_compact();
+    test_find_candidates();
+    test_find_candidates_bucketed();
+    test_find_candidates_coarse();
+    test_find_candidates_windows();
+    test_prune_candidates();
+    test_tracker();
+    test_dt_estimator();
+    test_ldpc_tables();
+    test_min_sum_decode();
+    test_layered_decode();
+    test_decode_candidates_batch();
+    test_sync_planes();
+    test_sync_search();
+
     return 0;
 }
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+# Generates the edge-indexed and bit-packed LDPC graph tables of ft8/constants.c from kFTX_LDPC_Nm and kFTX_LDPC_Mn.
+# Usage: python3 utils/gen_ldpc_tables.py < ft8/constants.c
+
+import sys
+import re
+
+N, M = 174, 83
+
+
+def parse_table(text, name):
+    body = re.search(name + r'\[[^]]*\]\[\d+\] = \{(.*?)\n\};', text, re.S).group(1)
+    return [[int(x) for x in row.split(',')] for row in re.findall(r'\{([^}]*)\}', body)]
+
+
+def print_array(decl, values, per_line):
+    print('%s = {' % decl)
+    for i in range(0, len(values), per_line):
+        print('    ' + ', '.join(str(v) for v in values[i:i + per_line]) + ',')
+    print('};\n')
+
+
+def print_rows(decl, rows, fmt=str):
+    print('%s = {' % decl)
+    for row in rows:
+        print('    { ' + ', '.join(fmt(v) for v in row) + ' },')
+    print('};\n')
+
+
+def pack_words(indices, num_words):
+    # Bit i goes to word i / 64, starting from the MSB (same order as the byte-packed tables)
+    words = [0] * num_words
+    for i in indices:
+        words[i // 64] |= 1 << (63 - i % 64)
+    return words
+
+
+def hex64(x):
+    return '0x%016xull' % x
+
+
+text = sys.stdin.read()
+Nm = [[n - 1 for n in row if n != 0] for row in parse_table(text, 'kFTX_LDPC_Nm')]
+Mn = [[m - 1 for m in row] for row in parse_table(text, 'kFTX_LDPC_Mn')]
+assert len(Nm) == M and len(Mn) == N
+
+# Edges ordered by check node
+offset = [0]
+edge_bit = []
+for row in Nm:
+    edge_bit += row
+    offset.append(len(edge_bit))
+# Edges ordered by bit (3 per bit, in the order of Mn) and the links between both orders
+bit_edge = [[offset[m] + Nm[m].index(n) for m in Mn[n]] for n in range(N)]
+edge_slot = [0] * len(edge_bit)
+for n in range(N):
+    for j, e in enumerate(bit_edge[n]):
+        edge_slot[e] = 3 * n + j
+
+# Bit-packed rows of the parity check matrix, and the parity checks of each bit packed as a syndrome
+check_mask = [pack_words(row, (N + 63) // 64) for row in Nm]
+bit_syndrome = [pack_words(row, (M + 63) // 64) for row in Mn]
+
+print('// Generated by utils/gen_ldpc_tables.py\n')
+print_array('const uint16_t kFTX_LDPC_Check_offset[FTX_LDPC_M + 1]', offset, 12)
+print_array('const uint8_t kFTX_LDPC_Edge_bit[FTX_LDPC_NUM_EDGES]', edge_bit, 16)
+print_array('const uint16_t kFTX_LDPC_Edge_slot[FTX_LDPC_NUM_EDGES]', edge_slot, 12)
+print_rows('const uint8_t kFTX_LDPC_Bit_check[FTX_LDPC_N][3]', Mn)
+print_rows('const uint16_t kFTX_LDPC_Bit_edge[FTX_LDPC_N][3]', bit_edge)
+print_rows('const uint64_t kFTX_LDPC_Check_mask[FTX_LDPC_M][FTX_LDPC_N_WORDS]', check_mask, hex64)
+print_rows('const uint64_t kFTX_LDPC_Bit_syndrome[FTX_LDPC_N][FTX_LDPC_M_WORDS]', bit_syndrome, hex64)